@@ -0,0 +1,139 @@
+// Writing and scanning a large buffer of uint64_t: a vl_vector, which maps
+// buffers of at least HUGE_PAGE_THRESHOLD bytes on transparent huge pages,
+// against a plain new uint64_t[]:
+//   g++ -std=c++17 -O2 -DNDEBUG -I.. bench_vl_huge_pages.cpp
+//   ./a.out [bytes = 1e9]
+// The kernel only backs the mapping with huge pages when
+// /sys/kernel/mm/transparent_hugepage/enabled is "always" or "madvise".
+#include "../vl_vector.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+/**
+ * @param fn A function to time.
+ * @return The shortest time of 3 runs of fn, in seconds.
+ */
+template<typename Fn>
+double best_of_3 (Fn fn)
+{
+  using clock = std::chrono::steady_clock;
+  double best = 0;
+  for (int i = 0; i < 3; ++i)
+    {
+      const auto start = clock::now ();
+      fn ();
+      const std::chrono::duration<double> seconds = clock::now () - start;
+      best = (i == 0) ? seconds.count () : std::min (best, seconds.count ());
+    }
+  return best;
+}
+
+/**
+ * @return the kB of anonymous memory of the process on huge pages, or 0
+ *         if it can't be read.
+ */
+size_t anon_huge_kb ()
+{
+  size_t total = 0;
+  FILE *smaps = std::fopen ("/proc/self/smaps_rollup", "r");
+  if (smaps == nullptr)
+    {
+      return 0;
+    }
+  char line[256];
+  while (std::fgets (line, sizeof (line), smaps) != nullptr)
+    {
+      size_t kb;
+      if (std::sscanf (line, "AnonHugePages: %zu kB", &kb) == 1)
+        {
+          total += kb;
+        }
+    }
+  std::fclose (smaps);
+  return total;
+}
+
+/**
+ * Times the first write of a buffer, which takes its page faults, and then
+ * a sequential sum of it and a sum at a stride of a page, which is bound
+ * by TLB misses.
+ * @param name The name of the buffer.
+ * @param data The buffer.
+ * @param n Number of elements.
+ * @return The sum at a stride, which is the same for every buffer.
+ */
+uint64_t run (const char *name, uint64_t *data, const size_t n)
+{
+  const auto start = std::chrono::steady_clock::now ();
+  for (size_t i = 0; i < n; ++i)
+    {
+      data[i] = i;
+    }
+  const std::chrono::duration<double> first_touch =
+      std::chrono::steady_clock::now () - start;
+  uint64_t sums[2] = {};
+  const double scan = best_of_3 ([&] {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i)
+      {
+        sum += data[i];
+      }
+    sums[0] = sum;
+  });
+  // 4 KiB apart, so every load is on another small page.
+  const size_t stride = 4096 / sizeof (uint64_t);
+  const double strided = best_of_3 ([&] {
+    uint64_t sum = 0;
+    for (size_t offset = 0; offset < stride; offset += 8)
+      {
+        for (size_t i = offset; i < n; i += stride)
+          {
+            sum += data[i];
+          }
+      }
+    sums[1] = sum;
+  });
+  if (sums[0] != (uint64_t) n * (n - 1) / 2)
+    {
+      std::printf ("wrong sum\n");
+      std::exit (1);
+    }
+  const double gb = (double) (n * sizeof (uint64_t)) / 1e9;
+  std::printf ("%-24s first write %6.2f GB/s  scan %6.2f GB/s  "
+               "page strided %7.3f s\n", name, gb / first_touch.count (),
+               gb / scan, strided);
+  return sums[1];
+}
+
+int main (int argc, char **argv)
+{
+  const size_t bytes = (argc > 1) ? (size_t) std::strtod (argv[1], nullptr)
+                                  : 1000000000;
+  const size_t n = bytes / sizeof (uint64_t);
+  std::printf ("%zu MB, huge pages from %zu MB\n", bytes >> 20,
+               (size_t) HUGE_PAGE_THRESHOLD >> 20);
+  uint64_t strided;
+  {
+    std::unique_ptr<uint64_t[]> plain (new uint64_t[n]);
+    strided = run ("new uint64_t[]", plain.get (), n);
+    std::printf ("  %zu MB on huge pages\n", anon_huge_kb () >> 10);
+  }
+  {
+    vl_vector<uint64_t, 0> huge;
+    huge.reserve (n);
+    huge.resize (n);
+    if (run ("vl_vector", huge.data (), n) != strided)
+      {
+        std::printf ("results differ\n");
+        return 1;
+      }
+    std::printf ("  %zu MB on huge pages, advise () %s\n",
+                 anon_huge_kb () >> 10,
+                 huge.advise (MADV_SEQUENTIAL) ? "true" : "false");
+  }
+  return 0;
+}
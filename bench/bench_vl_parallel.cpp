@@ -0,0 +1,102 @@
+// Scaling of the parallel algorithms against the serial std:: ones. The
+// pool size is fixed when the program is built, so build once per count:
+//   for t in 1 2 4 8; do
+//     g++ -std=c++17 -O2 -DNDEBUG -pthread -DPARALLEL_THREADS=$t -I..
+//         bench_vl_parallel.cpp -o bench_$t && ./bench_$t [elements = 1e7]
+//   done
+#include "../vl_parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+
+/**
+ * @param fn A function to time.
+ * @return The shortest time of 3 runs of fn, in seconds.
+ */
+template<typename Fn>
+double best_of_3 (Fn fn)
+{
+  using clock = std::chrono::steady_clock;
+  double best = 0;
+  for (int i = 0; i < 3; ++i)
+    {
+      const auto start = clock::now ();
+      fn ();
+      const std::chrono::duration<double> seconds = clock::now () - start;
+      best = (i == 0) ? seconds.count () : std::min (best, seconds.count ());
+    }
+  return best;
+}
+
+/**
+ * Prints the times of the serial and the parallel versions of an
+ * algorithm.
+ * @param name The name of the algorithm.
+ * @param serial The serial version.
+ * @param parallel The parallel version.
+ */
+template<typename Serial, typename Parallel>
+void compare (const char *name, Serial serial, Parallel parallel)
+{
+  const double s = best_of_3 (serial);
+  const double p = best_of_3 (parallel);
+  std::printf ("%-16s serial %8.3f s parallel %8.3f s speedup %5.2f\n", name,
+               s, p, s / p);
+}
+
+int main (int argc, char **argv)
+{
+  const size_t n = (argc > 1) ? (size_t) std::strtod (argv[1], nullptr)
+                              : 10000000;
+  std::printf ("%zu elements, %zu workers\n", n,
+               vl_thread_pool::instance ().size ());
+  vl_vector<double, 0> in (n);
+  std::mt19937_64 random (1);
+  std::uniform_real_distribution<double> values (0, 1);
+  std::generate (in.begin (), in.end (), [&] { return values (random); });
+  vl_vector<double, 0> out (n);
+  vl_vector<double, 0> a (n);
+  vl_vector<double, 0> b (n);
+  const auto work = [] (double x) { return std::sqrt (x) * 3 + 1; };
+
+  compare ("for_each", [&] {
+    std::for_each (a.begin (), a.end (), [] (double &x) { x = x * 0.5 + 1; });
+  }, [&] {
+    vl_parallel::for_each (b, [] (double &x) { x = x * 0.5 + 1; });
+  });
+  compare ("transform", [&] {
+    std::transform (in.begin (), in.end (), out.begin (), work);
+  }, [&] {
+    vl_parallel::transform (in, out, work);
+  });
+  double serial_sum = 0;
+  double parallel_sum = 0;
+  compare ("reduce", [&] {
+    serial_sum = std::reduce (in.begin (), in.end (), 0.0);
+  }, [&] {
+    parallel_sum = vl_parallel::reduce (in, 0.0);
+  });
+  compare ("inclusive_scan", [&] {
+    std::inclusive_scan (in.begin (), in.end (), out.begin ());
+  }, [&] {
+    vl_parallel::inclusive_scan (in, out);
+  });
+  compare ("sort", [&] {
+    std::copy (in.begin (), in.end (), a.begin ());
+    std::sort (a.begin (), a.end ());
+  }, [&] {
+    std::copy (in.begin (), in.end (), b.begin ());
+    vl_parallel::sort (b);
+  });
+  if (!std::equal (a.begin (), a.end (), b.begin ())
+      || std::abs (serial_sum - parallel_sum) > 1e-6 * serial_sum)
+    {
+      std::printf ("results differ\n");
+      return 1;
+    }
+  return 0;
+}
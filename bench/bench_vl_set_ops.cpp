@@ -0,0 +1,115 @@
+// The sorted set operations against std::set_* with a back_inserter, on
+// random uint32_t sets at several size ratios:
+//   g++ -std=c++17 -O2 -DNDEBUG -I.. bench_vl_set_ops.cpp
+//   ./a.out [elements of the larger set = 4e6]
+// Build with -DSET_SIMD_UNION=1 to time the SSE2 merge network for unions.
+#include "../vl_set_ops.h"
+#include "../vl_vector.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <vector>
+
+using set = vl_vector<uint32_t, 0>;
+
+/**
+ * @param n Number of elements.
+ * @param range The elements are drawn from [0, range).
+ * @param random The generator.
+ * @return A sorted set of about n elements.
+ */
+set random_set (const size_t n, const uint32_t range, std::mt19937 &random)
+{
+  std::vector<uint32_t> elements (n);
+  for (uint32_t &x : elements)
+    {
+      x = random () % range;
+    }
+  std::sort (elements.begin (), elements.end ());
+  elements.erase (std::unique (elements.begin (), elements.end ()),
+                  elements.end ());
+  return set (elements.begin (), elements.end ());
+}
+
+/**
+ * @param fn A function to time.
+ * @return The shortest time of 5 runs of fn, in milliseconds.
+ */
+template<typename Fn>
+double best_of_5 (Fn fn)
+{
+  using clock = std::chrono::steady_clock;
+  double best = 0;
+  for (int i = 0; i < 5; ++i)
+    {
+      const auto start = clock::now ();
+      fn ();
+      const std::chrono::duration<double, std::milli> ms =
+          clock::now () - start;
+      best = (i == 0) ? ms.count () : std::min (best, ms.count ());
+    }
+  return best;
+}
+
+/**
+ * Prints the times of an operation and of its std:: version.
+ * @param name The name of the operation.
+ * @param ours The operation, which appends to a vl_vector.
+ * @param theirs The std:: version, which appends to a std::vector.
+ */
+template<typename Ours, typename Theirs>
+void compare (const char *name, Ours ours, Theirs theirs)
+{
+  set dst;
+  std::vector<uint32_t> expected;
+  const double ours_ms = best_of_5 ([&] {
+    dst.clear ();
+    ours (dst);
+  });
+  const double theirs_ms = best_of_5 ([&] {
+    expected.clear ();
+    theirs (std::back_inserter (expected));
+  });
+  if (!std::equal (dst.begin (), dst.end (), expected.begin (),
+                   expected.end ()))
+    {
+      std::printf ("%s differs\n", name);
+      std::exit (1);
+    }
+  std::printf ("  %-10s %8.2f ms  std %8.2f ms\n", name, ours_ms, theirs_ms);
+}
+
+int main (int argc, char **argv)
+{
+  const size_t n = (argc > 1) ? (size_t) std::strtod (argv[1], nullptr)
+                              : 4000000;
+  std::mt19937 random (1);
+  for (const size_t ratio : {1, 64, 1024})
+    {
+      const set a = random_set (n / ratio, (uint32_t) (4 * n), random);
+      const set b = random_set (n, (uint32_t) (4 * n), random);
+      std::printf ("1:%zu (%zu and %zu elements)\n", ratio, a.size (),
+                   b.size ());
+      compare ("intersect", [&] (set &dst) {
+        vl_set_intersect (a, b, dst);
+      }, [&] (auto out) {
+        std::set_intersection (a.begin (), a.end (), b.begin (), b.end (),
+                               out);
+      });
+      compare ("union", [&] (set &dst) {
+        vl_set_union (a, b, dst);
+      }, [&] (auto out) {
+        std::set_union (a.begin (), a.end (), b.begin (), b.end (), out);
+      });
+      compare ("difference", [&] (set &dst) {
+        vl_set_difference (a, b, dst);
+      }, [&] (auto out) {
+        std::set_difference (a.begin (), a.end (), b.begin (), b.end (),
+                             out);
+      });
+    }
+  return 0;
+}
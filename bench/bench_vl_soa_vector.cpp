@@ -0,0 +1,80 @@
+// A loop that updates one field of every row from another field, over rows
+// stored as a struct of arrays in a vl_soa_vector, against an array of
+// structs in a std::vector:
+//   g++ -std=c++17 -O2 -DNDEBUG -I.. bench_vl_soa_vector.cpp
+//   ./a.out [rows = 4e6]
+#include "../vl_soa_vector.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * A particle of 8 fields and 56 bytes, of which the loop touches 2.
+ */
+struct particle {
+  double x, y, z; // position.
+  double vx, vy, vz; // velocity.
+  float mass, charge;
+};
+
+/**
+ * @param fn A function to time.
+ * @return The shortest time of 5 runs of fn, in seconds.
+ */
+template<typename Fn>
+double best_of_5 (Fn fn)
+{
+  using clock = std::chrono::steady_clock;
+  double best = 0;
+  for (int i = 0; i < 5; ++i)
+    {
+      const auto start = clock::now ();
+      fn ();
+      const std::chrono::duration<double> seconds = clock::now () - start;
+      best = (i == 0) ? seconds.count () : std::min (best, seconds.count ());
+    }
+  return best;
+}
+
+int main (int argc, char **argv)
+{
+  const size_t n = (argc > 1) ? (size_t) std::strtod (argv[1], nullptr)
+                              : 4000000;
+  const double dt = 0.01;
+  std::vector<particle> aos (n);
+  vl_soa_vector<double, double, double, double, double, double, float, float>
+      soa;
+  soa.reserve (n);
+  for (size_t i = 0; i < n; ++i)
+    {
+      const double v = (double) (i % 100);
+      aos[i] = particle{0, 0, 0, v, 0, 0, 1, 0};
+      soa.push_back (0, 0, 0, v, 0, 0, 1, 0);
+    }
+
+  const double aos_seconds = best_of_5 ([&] {
+    for (particle &p : aos)
+      {
+        p.x += p.vx * dt;
+      }
+  });
+  const double soa_seconds = best_of_5 ([&] {
+    double *x = soa.data<0> ();
+    const double *vx = soa.data<3> ();
+    for (size_t i = 0; i < n; ++i)
+      {
+        x[i] += vx[i] * dt;
+      }
+  });
+  if (aos[n - 1].x != soa.data<0> ()[n - 1])
+    {
+      std::printf ("results differ\n");
+      return 1;
+    }
+  std::printf ("%zu rows of %zu bytes\n", n, sizeof (particle));
+  std::printf ("AoS std::vector   %8.3f s\n", aos_seconds);
+  std::printf ("SoA vl_soa_vector %8.3f s\n", soa_seconds);
+  return 0;
+}
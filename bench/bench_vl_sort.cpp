@@ -0,0 +1,126 @@
+// vl_vector::sort against std::sort on a std::vector, on random uint32_t,
+// int64_t and double, from sizes that stay inline and go to the sorting
+// networks, through the radix sort threshold, up to the given size:
+//   g++ -std=c++17 -O2 -DNDEBUG -I.. bench_vl_sort.cpp
+//   ./a.out [largest size = 1e7, up to 1e8 with a few GB of memory]
+// Small sizes are timed over many vectors, about as many elements in total
+// as the largest size, and the times are per element.
+#include "../vl_vector.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+/**
+ * @param reset A function that restores the input, which isn't timed.
+ * @param fn A function to time.
+ * @return The shortest time of 3 runs of fn, in seconds.
+ */
+template<typename Reset, typename Fn>
+double best_of_3 (Reset reset, Fn fn)
+{
+  using clock = std::chrono::steady_clock;
+  double best = 0;
+  for (int i = 0; i < 3; ++i)
+    {
+      reset ();
+      const auto start = clock::now ();
+      fn ();
+      const std::chrono::duration<double> seconds = clock::now () - start;
+      best = (i == 0) ? seconds.count () : std::min (best, seconds.count ());
+    }
+  return best;
+}
+
+/**
+ * Times sorting batches of n random elements, with the elements of each
+ * batch in a vl_vector, inline when they fit, and in a std::vector.
+ * @param name The name of T.
+ * @param n Number of elements of a batch.
+ * @param total About how many elements all the batches have.
+ */
+template<typename T>
+void compare (const char *name, const size_t n, const size_t total)
+{
+  const size_t batches = std::max ((size_t) 1, total / n);
+  std::mt19937_64 random (n);
+  std::vector<T> in (n * batches);
+  for (T &x : in)
+    {
+      const uint64_t bits = random ();
+      x = std::is_floating_point<T>::value ? (T) ((double) bits / 1e10)
+                                           : (T) bits;
+    }
+  std::vector<vl_vector<T>> ours (batches);
+  std::vector<std::vector<T>> theirs (batches);
+  const double ours_s = best_of_3 ([&] {
+    for (size_t b = 0; b < batches; ++b)
+      {
+        ours[b] = vl_vector<T> (in.begin () + b * n,
+                                in.begin () + (b + 1) * n);
+      }
+  }, [&] {
+    for (vl_vector<T> &v : ours)
+      {
+        v.sort ();
+      }
+  });
+  const double theirs_s = best_of_3 ([&] {
+    for (size_t b = 0; b < batches; ++b)
+      {
+        theirs[b].assign (in.begin () + b * n, in.begin () + (b + 1) * n);
+      }
+  }, [&] {
+    for (std::vector<T> &v : theirs)
+      {
+        std::sort (v.begin (), v.end ());
+      }
+  });
+  for (size_t b = 0; b < batches; ++b)
+    {
+      if (!std::equal (ours[b].begin (), ours[b].end (), theirs[b].begin (),
+                       theirs[b].end ()))
+        {
+          std::printf ("%s: results differ at %zu elements\n", name, n);
+          std::exit (1);
+        }
+    }
+  const double elements = (double) (n * batches);
+  std::printf ("%-8s %10zu %-6s %8.2f ns  std::sort %8.2f ns  speedup %5.2f\n",
+               name, n, (n <= vl_budget_capacity<T>) ? "inline" : "heap",
+               ours_s / elements * 1e9, theirs_s / elements * 1e9,
+               theirs_s / ours_s);
+}
+
+/**
+ * Compares the sorts of T at every size from 4 to largest.
+ * @param name The name of T.
+ * @param largest The largest size.
+ */
+template<typename T>
+void compare_sizes (const char *name, const size_t largest)
+{
+  for (const size_t n : {(size_t) 4, (size_t) 8, (size_t) 16, (size_t) 64,
+                         (size_t) 256, (size_t) 1000, (size_t) 10000,
+                         (size_t) 100000, (size_t) 1000000, (size_t) 10000000,
+                         (size_t) 100000000})
+    {
+      if (n <= largest)
+        {
+          compare<T> (name, n, largest);
+        }
+    }
+}
+
+int main (int argc, char **argv)
+{
+  const size_t largest = (argc > 1) ? (size_t) std::strtod (argv[1], nullptr)
+                                    : 10000000;
+  std::printf ("time per element\n");
+  compare_sizes<uint32_t> ("uint32_t", largest);
+  compare_sizes<int64_t> ("int64_t", largest);
+  compare_sizes<double> ("double", largest);
+  return 0;
+}
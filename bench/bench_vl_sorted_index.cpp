@@ -0,0 +1,86 @@
+// Random lookups in a sorted table of uint64_t: std::lower_bound against
+// vl_vector::lower_bound, which has no branches, and vl_sorted_index, which
+// searches a copy in Eytzinger order:
+//   g++ -std=c++17 -O2 -DNDEBUG -I.. bench_vl_sorted_index.cpp
+//   ./a.out [elements = 3e7] [lookups = 5e6]
+#include "../vl_sorted_index.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+/**
+ * @param fn A function to time.
+ * @return The shortest time of 3 runs of fn, in seconds.
+ */
+template<typename Fn>
+double best_of_3 (Fn fn)
+{
+  using clock = std::chrono::steady_clock;
+  double best = 0;
+  for (int i = 0; i < 3; ++i)
+    {
+      const auto start = clock::now ();
+      fn ();
+      const std::chrono::duration<double> seconds = clock::now () - start;
+      best = (i == 0) ? seconds.count () : std::min (best, seconds.count ());
+    }
+  return best;
+}
+
+int main (int argc, char **argv)
+{
+  const size_t n = (argc > 1) ? (size_t) std::strtod (argv[1], nullptr)
+                              : 30000000;
+  const size_t lookups = (argc > 2) ? (size_t) std::strtod (argv[2], nullptr)
+                                    : 5000000;
+  std::mt19937_64 random (1);
+  vl_vector<uint64_t, 0> table (n);
+  for (uint64_t &x : table)
+    {
+      x = random ();
+    }
+  std::sort (table.begin (), table.end ());
+  vl_vector<uint64_t, 0> keys (lookups);
+  for (uint64_t &x : keys)
+    {
+      x = random ();
+    }
+  const vl_sorted_index<uint64_t> index (table.data (), table.data () + n);
+
+  // the sums of the positions found, which must be the same.
+  size_t sums[3] = {};
+  const double std_seconds = best_of_3 ([&] {
+    sums[0] = 0;
+    for (const uint64_t key : keys)
+      {
+        sums[0] += std::lower_bound (table.data (), table.data () + n, key)
+                   - table.data ();
+      }
+  });
+  const double member_seconds = best_of_3 ([&] {
+    sums[1] = 0;
+    for (const uint64_t key : keys)
+      {
+        sums[1] += table.lower_bound (key) - table.begin ();
+      }
+  });
+  const double index_seconds = best_of_3 ([&] {
+    sums[2] = 0;
+    for (const uint64_t key : keys)
+      {
+        sums[2] += index.lower_bound (key);
+      }
+  });
+  if (sums[0] != sums[1] || sums[0] != sums[2])
+    {
+      std::printf ("results differ\n");
+      return 1;
+    }
+  std::printf ("%zu lookups in %zu elements\n", lookups, n);
+  std::printf ("std::lower_bound         %8.3f s\n", std_seconds);
+  std::printf ("vl_vector::lower_bound   %8.3f s\n", member_seconds);
+  std::printf ("vl_sorted_index          %8.3f s\n", index_seconds);
+  return 0;
+}
@@ -0,0 +1,59 @@
+// Append throughput of a vl_vector that grows to a large size, against
+// std::vector:
+//   g++ -std=c++17 -O2 -DNDEBUG -I.. bench_vl_vector_growth.cpp
+//   ./a.out [MiB = 1024] [vl | std]
+// Large buffers grow with mremap; build with
+// -DHUGE_PAGE_THRESHOLD='(~(size_t) 0)' to compare with allocate-and-copy.
+// Run a single container per process for a meaningful peak RSS.
+#include "../vl_vector.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/resource.h>
+#include <vector>
+
+/**
+ * Appends n ints to an empty vector one at a time, and prints the time.
+ * @tparam Vector The type of the vector.
+ * @param name The name to print.
+ * @param n Number of elements.
+ */
+template<typename Vector>
+void append (const char *name, const size_t n)
+{
+  const auto start = std::chrono::steady_clock::now ();
+  Vector v;
+  for (size_t i = 0; i < n; ++i)
+    {
+      v.push_back ((int) i);
+    }
+  const std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now () - start;
+  if (v[n / 2] != (int) (n / 2))
+    {
+      std::abort ();
+    }
+  const double gib = (double) (n * sizeof (int)) / (1 << 30);
+  std::printf ("%-12s %8.3f s %8.2f GiB/s\n", name, seconds.count (),
+               gib / seconds.count ());
+}
+
+int main (int argc, char **argv)
+{
+  const size_t mib = (argc > 1) ? std::strtoull (argv[1], nullptr, 10) : 1024;
+  const size_t n = mib * 1024 * 1024 / sizeof (int);
+  const char *which = (argc > 2) ? argv[2] : "";
+  if (std::strcmp (which, "std") != 0)
+    {
+      append<vl_vector<int, 0>> ("vl_vector", n);
+    }
+  if (std::strcmp (which, "vl") != 0)
+    {
+      append<std::vector<int>> ("std::vector", n);
+    }
+  rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  std::printf ("peak RSS %ld MiB\n", usage.ru_maxrss / 1024);
+  return 0;
+}
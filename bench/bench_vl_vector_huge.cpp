@@ -0,0 +1,87 @@
+// A stress run of a vl_vector<uint8_t> with more elements than a 32-bit
+// index can reach: it grows to the given size, and indexes, inserts and
+// erases past 2^32:
+//   g++ -std=c++17 -O2 -DNDEBUG -I.. bench_vl_vector_huge.cpp
+//   ./a.out [elements = 5e9] [stride of the checked elements = 2^28]
+// The buffer is mapped on huge pages, whose fresh memory is already zero,
+// so the first half is never written and the run needs about n / 2 bytes
+// of memory, and n of address space.
+#include "../vl_vector.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * Prints a step and how long it took since the last one.
+ * @param step The name of the step.
+ */
+void lap (const char *step)
+{
+  using clock = std::chrono::steady_clock;
+  static clock::time_point last = clock::now ();
+  const clock::time_point now = clock::now ();
+  const std::chrono::duration<double, std::milli> ms = now - last;
+  std::printf ("%-40s %10.3f ms\n", step, ms.count ());
+  last = now;
+}
+
+/**
+ * Stops the program if a check fails.
+ * @param ok The result of the check.
+ * @param what What was checked.
+ */
+void check (const bool ok, const char *what)
+{
+  if (!ok)
+    {
+      std::printf ("failed: %s\n", what);
+      std::exit (1);
+    }
+}
+
+int main (int argc, char **argv)
+{
+  const size_t n = (argc > 1) ? (size_t) std::strtod (argv[1], nullptr)
+                              : 5000000000;
+  const size_t stride = (argc > 2) ? (size_t) std::strtod (argv[2], nullptr)
+                                   : (size_t) 1 << 28;
+  std::printf ("%zu elements, %zu above 2^32\n", n,
+               (n > ((size_t) 1 << 32)) ? n - ((size_t) 1 << 32) : 0);
+  lap ("start");
+  vl_vector<uint8_t, 0> v (n / 2, (uint8_t) 0);
+  lap ("construct n / 2 zeros");
+  v.reserve (n);
+  lap ("reserve n, which grows with mremap");
+  v.resize (n);
+  lap ("resize to n, which writes n / 2 zeros");
+  for (size_t i = 0; i < n; i += stride)
+    {
+      v[i] = (uint8_t) (i / stride + 1);
+    }
+  v[n - 1] = 0xAB;
+  lap ("write every stride");
+  for (size_t i = 0; i < n; i += stride)
+    {
+      check (v.at (i) == (uint8_t) (i / stride + 1), "at (i)");
+      check (*(v.begin () + (std::ptrdiff_t) i) == v[i], "begin () + i");
+    }
+  check ((size_t) (v.end () - v.begin ()) == n, "end () - begin ()");
+  check (v[v.size () - 1] == 0xAB, "last element");
+  lap ("read every stride");
+  for (int i = 0; i < 1000; ++i)
+    {
+      v.push_back ((uint8_t) i);
+    }
+  check (v.size () == n + 1000 && v[n + 999] == (uint8_t) 999, "push_back");
+  lap ("push_back 1000 past the end");
+  v.insert (v.end () - 500, (uint8_t) 7);
+  check (v[n + 500] == 7 && v[v.size () - 1] == (uint8_t) 999, "insert");
+  v.erase (v.end () - 1001, v.end ());
+  check (v.size () == n && v[v.size () - 1] == 0xAB, "erase");
+  lap ("insert and erase at the end");
+  v.pop_back ();
+  check (v.size () == n - 1 && v[0] == 1, "pop_back");
+  v = vl_vector<uint8_t, 0> ();
+  lap ("pop_back and free");
+  return 0;
+}
@@ -0,0 +1,214 @@
+// Smoke tests for vl_bitvector, meant to run under the sanitizers:
+//   g++ -std=c++17 -g -Wall -Wextra -Wpedantic -fsanitize=address,undefined
+//       -I.. test_vl_bitvector.cpp
+#include "../vl_bitvector.h"
+#include <cassert>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @param bits A bit vector.
+ * @param ref The bits it should have.
+ * @return true if bits has the bits of ref, and its count, searches and
+ *         last word agree with them.
+ */
+template<const size_t N>
+bool matches (const vl_bitvector<N> &bits, const std::vector<bool> &ref)
+{
+  if (bits.size () != ref.size ()
+      || bits.word_count () != (ref.size () + 63) / 64)
+    {
+      return false;
+    }
+  size_t count = 0;
+  size_t next = ref.size ();
+  for (size_t i = ref.size (); i-- > 0;)
+    {
+      if (bits[i] != ref[i] || bits.find_next (i) != (ref[i] ? i : next))
+        {
+          return false;
+        }
+      if (ref[i])
+        {
+          ++count;
+          next = i;
+        }
+    }
+  // the bits past the size in the last word are 0.
+  if (ref.size () % 64 != 0
+      && bits.data ()[bits.word_count () - 1] >> (ref.size () % 64) != 0)
+    {
+      return false;
+    }
+  return bits.count () == count && bits.find_first () == next
+         && bits.any () == (count != 0) && bits.all () == (count == ref.size ());
+}
+
+/**
+ * set, reset, flip, count and the searches around the 64 bit boundaries,
+ * on the stack and on the heap.
+ */
+void test_word_boundaries ()
+{
+  for (const size_t n : {1, 63, 64, 65, 127, 128, 129, 200, 1000})
+    {
+      vl_bitvector<128> bits (n);
+      std::vector<bool> ref (n);
+      assert (matches (bits, ref) && bits.find_first () == n && bits.none ());
+      for (const size_t i : {0, 1, 62, 63, 64, 65, 127, 128, 129, 191, 199})
+        {
+          if (i < n)
+            {
+              bits.set (i);
+              ref[i] = true;
+              assert (matches (bits, ref));
+            }
+        }
+      for (const size_t i : {63, 128})
+        {
+          if (i < n)
+            {
+              bits.flip (i);
+              ref[i] = !ref[i];
+              bits.reset (0);
+              ref[0] = false;
+              assert (matches (bits, ref));
+            }
+        }
+      bits.fill (true);
+      assert (matches (bits, std::vector<bool> (n, true)));
+      assert (bits.find_next (n) == n && bits.find_next (n + 100) == n);
+    }
+  vl_bitvector<64> one (10);
+  assert (!one.test (9));
+  try
+    {
+      one.test (10);
+      assert (false);
+    }
+  catch (const std::out_of_range &)
+    {
+    }
+}
+
+/**
+ * &=, |=, ^= and and_not against a reference, with sizes that end inside a
+ * word, with odd word counts that take the tail after the SSE2 loop, and
+ * between vectors of different stack capacities.
+ */
+void test_bitwise ()
+{
+  std::mt19937 random (1);
+  for (const size_t n : {1, 10, 63, 64, 65, 100, 129, 191, 257, 1000})
+    {
+      vl_bitvector<64> a (n);
+      vl_bitvector<512> b (n);
+      std::vector<bool> ra (n), rb (n);
+      for (size_t i = 0; i < n; ++i)
+        {
+          ra[i] = random () % 2;
+          rb[i] = random () % 3 == 0;
+          a.set (i, ra[i]);
+          b.set (i, rb[i]);
+        }
+      assert (matches (a, ra) && matches (b, rb));
+
+      vl_bitvector<64> r = a;
+      std::vector<bool> rr = ra;
+      r &= b;
+      for (size_t i = 0; i < n; ++i)
+        {
+          rr[i] = ra[i] && rb[i];
+        }
+      assert (matches (r, rr));
+
+      r = a;
+      r |= b;
+      for (size_t i = 0; i < n; ++i)
+        {
+          rr[i] = ra[i] || rb[i];
+        }
+      assert (matches (r, rr));
+
+      r = a;
+      r ^= b;
+      for (size_t i = 0; i < n; ++i)
+        {
+          rr[i] = ra[i] != rb[i];
+        }
+      assert (matches (r, rr));
+
+      r = a;
+      r.and_not (b);
+      for (size_t i = 0; i < n; ++i)
+        {
+          rr[i] = ra[i] && !rb[i];
+        }
+      assert (matches (r, rr));
+
+      // all ones on both sides keeps the tail 0.
+      vl_bitvector<64> ones (n, true);
+      ones ^= vl_bitvector<64> (n, false);
+      ones |= vl_bitvector<64> (n, true);
+      assert (matches (ones, std::vector<bool> (n, true)));
+
+      try
+        {
+          r &= vl_bitvector<64> (n + 1);
+          assert (false);
+        }
+      catch (const std::invalid_argument &)
+        {
+        }
+    }
+}
+
+/**
+ * resize and push_back keep the bits past the size 0, so shrinking and
+ * growing again with 0 doesn't bring back old bits, and growing with 1
+ * only sets the new bits.
+ */
+void test_resize ()
+{
+  vl_bitvector<64> bits (130, true);
+  std::vector<bool> ref (130, true);
+  assert (matches (bits, ref));
+  bits.resize (70);
+  ref.resize (70);
+  assert (matches (bits, ref));
+  bits.resize (100);
+  ref.resize (100, false);
+  assert (matches (bits, ref) && bits.find_next (70) == 100);
+  bits.resize (5);
+  ref.resize (5);
+  assert (matches (bits, ref));
+  bits.reset (2);
+  ref[2] = false;
+  bits.resize (140, true);
+  ref.resize (140, true);
+  assert (matches (bits, ref) && !bits[2]);
+  bits.resize (128);
+  ref.resize (128);
+  bits.resize (129, false);
+  ref.resize (129, false);
+  assert (matches (bits, ref));
+  for (size_t i = 0; i < 70; ++i)
+    {
+      bits.push_back (i % 3 == 0);
+      ref.push_back (i % 3 == 0);
+    }
+  assert (matches (bits, ref));
+  bits.clear ();
+  assert (bits.empty () && bits.word_count () == 0 && bits.none ());
+  bits.resize (64, true);
+  assert (matches (bits, std::vector<bool> (64, true)));
+}
+
+int main ()
+{
+  test_word_boundaries ();
+  test_bitwise ();
+  test_resize ();
+  return 0;
+}
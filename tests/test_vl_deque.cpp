@@ -0,0 +1,127 @@
+// Smoke tests for vl_deque, meant to run under the sanitizers:
+//   g++ -std=c++17 -g -fsanitize=address,undefined -I.. test_vl_deque.cpp
+#include "../vl_deque.h"
+#include <cassert>
+#include <deque>
+#include <string>
+
+/**
+ * Pushing an element of a full deque into itself, which grows it.
+ */
+void test_self_push ()
+{
+  const std::string s (40, 'x');
+  vl_deque<std::string, 4> d;
+  for (int i = 0; i < 4; ++i)
+    {
+      d.push_back (s);
+    }
+  d.push_back (d.front ());
+  assert (d.back () == s);
+  while (d.size () < d.capacity ())
+    {
+      d.push_back (s);
+    }
+  d.push_front (d.back ());
+  assert (d.front () == s);
+  while (d.size () < d.capacity ())
+    {
+      d.push_back (s);
+    }
+  d.push_back (std::move (d.front ()));
+  assert (d.back () == s);
+  for (const std::string &e : d)
+    {
+      assert (e == s || e.empty ());
+    }
+}
+
+/**
+ * Pushing and popping at both ends, against std::deque.
+ */
+void test_both_ends ()
+{
+  vl_deque<int, 4> d;
+  std::deque<int> expected;
+  for (int i = 0; i < 1000; ++i)
+    {
+      if (i % 3 == 0)
+        {
+          d.push_front (i);
+          expected.push_front (i);
+        }
+      else
+        {
+          d.push_back (i);
+          expected.push_back (i);
+        }
+      if (i % 5 == 0)
+        {
+          d.pop_front ();
+          expected.pop_front ();
+        }
+    }
+  assert (d.size () == expected.size ());
+  assert (std::equal (d.begin (), d.end (), expected.begin ()));
+}
+
+/**
+ * Draining the deque a contiguous chunk at a time.
+ */
+void test_chunks ()
+{
+  vl_deque<int> d;
+  for (int i = 0; i < 10; ++i)
+    {
+      d.push_back (i);
+    }
+  d.pop_front (6);
+  for (int i = 10; i < 25; ++i)
+    {
+      d.push_back (i);
+    }
+  int next = 6;
+  while (!d.empty ())
+    {
+      const std::pair<int *, size_t> chunk = d.front_chunk ();
+      for (size_t i = 0; i < chunk.second; ++i)
+        {
+          assert (chunk.first[i] == next++);
+        }
+      d.pop_front (chunk.second);
+    }
+  assert (next == 25);
+}
+
+/**
+ * The default ring is a power of 2 that fits in DEFAULT_STATIC_BYTES, and
+ * a single slot for elements larger than that.
+ */
+void test_budget ()
+{
+  static_assert (sizeof (vl_deque<char>) <= DEFAULT_STATIC_BYTES,
+                 "fits the budget");
+  static_assert (sizeof (vl_deque<double>) <= DEFAULT_STATIC_BYTES,
+                 "fits the budget");
+  static_assert (vl_deque<char>::StaticCapacity == 64, "64 chars inline");
+  struct big {
+    char bytes[512];
+  };
+  static_assert (vl_deque<big>::StaticCapacity == 1, "one big element");
+  vl_deque<big> d;
+  for (int i = 0; i < 5; ++i)
+    {
+      d.push_front (big{});
+      d.push_back (big{});
+    }
+  assert (d.size () == 10);
+}
+
+int main ()
+{
+  test_self_push ();
+  test_both_ends ();
+  test_chunks ();
+  test_budget ();
+  return 0;
+}
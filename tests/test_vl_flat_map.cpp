@@ -0,0 +1,49 @@
+// Smoke tests for vl_flat_set and vl_flat_map, meant to run under the
+// sanitizers:
+//   g++ -std=c++17 -g -Wall -Wextra -Wpedantic -fsanitize=address,undefined
+//       -I.. test_vl_flat_map.cpp
+#include "../vl_flat_map.h"
+#include "../vl_flat_set.h"
+#include <cassert>
+#include <string>
+
+/**
+ * A value larger than the byte budget.
+ */
+struct big {
+  char bytes[512];
+};
+
+/**
+ * The default containers keep each of their vectors within the budget of
+ * a default vl_vector, even when the keys or the values are large.
+ */
+void test_budget ()
+{
+  // the empty Compare is padded to a word.
+  static_assert (sizeof (vl_flat_set<int>) <= DEFAULT_STATIC_BYTES + 8,
+                 "one vector in the budget");
+  static_assert (sizeof (vl_flat_map<int, int>)
+                 <= 2 * DEFAULT_STATIC_BYTES + 8, "two vectors in the budget");
+  static_assert (sizeof (vl_flat_map<int, big>)
+                 < sizeof (big) + 2 * DEFAULT_STATIC_BYTES,
+                 "a single big value inline");
+  vl_flat_map<int, big> m;
+  for (int i = 0; i < 10; ++i)
+    {
+      m[9 - i].bytes[0] = (char) i;
+    }
+  assert (m.size () == 10 && m[0].bytes[0] == 9);
+  vl_flat_set<std::string> s;
+  for (int i = 0; i < 100; ++i)
+    {
+      s.insert (std::to_string (i % 50));
+    }
+  assert (s.size () == 50 && s.contains ("42"));
+}
+
+int main ()
+{
+  test_budget ();
+  return 0;
+}
@@ -0,0 +1,123 @@
+// Smoke tests for vl_hash_map, meant to run under the sanitizers:
+//   g++ -std=c++17 -g -Wall -Wextra -Wpedantic -fsanitize=address,undefined
+//       -I.. test_vl_hash_map.cpp
+#include "../vl_hash_map.h"
+#include "../vl_hash_set.h"
+#include <cassert>
+#include <memory>
+#include <string>
+
+/**
+ * Every slot holds a value, and erasing an entry resets its value, so the
+ * map doesn't keep what an erased value held.
+ */
+void test_erase_releases ()
+{
+  const std::shared_ptr<int> shared = std::make_shared<int> (7);
+  vl_hash_map<int, std::shared_ptr<int>> m;
+  for (int i = 0; i < 100; ++i)
+    {
+      m.insert (i, shared);
+    }
+  assert (shared.use_count () == 101);
+  for (int i = 0; i < 100; i += 2)
+    {
+      assert (m.erase (i) == 1);
+    }
+  assert (shared.use_count () == 51);
+  m.erase (m.find (1));
+  assert (shared.use_count () == 50 && m.find (1) == m.end ());
+  m.clear ();
+  assert (shared.use_count () == 1);
+}
+
+/**
+ * Inserting a value of the map into a full map, which rehashes and moves
+ * the values before the copy.
+ */
+void test_insert_own_value ()
+{
+  vl_hash_map<int, std::string, 1> m;
+  const size_t full = m.capacity () / 8 * 7;
+  for (int i = 0; i < (int) full; ++i)
+    {
+      m.insert (i, std::string (32, (char) ('a' + i)));
+    }
+  assert (m.capacity () == 16);
+  assert (m.insert (100, m.at (3)).second);
+  assert (m.capacity () > 16 && m.at (100) == std::string (32, 'd'));
+  for (int i = (int) full; m.capacity () == 32; ++i)
+    {
+      m.insert (i, "x");
+    }
+  assert (!m.insert_or_assign (100, m.at (4)).second);
+  assert (m.at (100) == std::string (32, 'e'));
+  assert (m.insert_or_assign (200, m.at (5)).second);
+  assert (m.at (200) == std::string (32, 'f'));
+  // The key is a value of the map here, which the rehash moves too.
+  vl_hash_map<std::string, std::string, 1> names;
+  for (size_t i = 0; i < full; ++i)
+    {
+      names.insert (std::string (1, (char) ('a' + i)),
+                    std::string (32, (char) ('A' + i)));
+    }
+  assert (names.insert (names.at ("c"), "value").second);
+  assert (names.at (std::string (32, 'C')) == "value");
+  assert (names.size () == full + 1);
+}
+
+/**
+ * A set finds, counts and erases its keys, including across a rehash, and
+ * inserts one of its own keys as a no-op.
+ */
+void test_set ()
+{
+  vl_hash_set<std::string, 1> s;
+  const size_t full = s.capacity () / 8 * 7;
+  for (size_t i = 0; i < full; ++i)
+    {
+      assert (s.insert (std::string (32, (char) ('a' + i))).second);
+    }
+  assert (!s.insert (std::string (32, 'a')).second && s.size () == full);
+  const std::string &own = *s.find (std::string (32, 'c'));
+  s.erase (own);
+  assert (s.insert (std::string (32, 'c')).second && s.size () == full);
+  assert (!s.insert (*s.find (std::string (32, 'd'))).second);
+  assert (s.insert ("new").second && s.capacity () > 16);
+  for (size_t i = 0; i < full; ++i)
+    {
+      assert (s.count (std::string (32, (char) ('a' + i))) == 1);
+    }
+  vl_hash_set<int> ints;
+  for (int i = 0; i < 1000; ++i)
+    {
+      ints.insert (i * 7);
+    }
+  assert (ints.size () == 1000 && ints.contains (700) && !ints.contains (701));
+  for (int i = 0; i < 1000; i += 2)
+    {
+      assert (ints.erase (i * 7) == 1);
+    }
+  assert (ints.size () == 500 && !ints.contains (0) && ints.contains (7));
+  size_t seen = 0;
+  for (const int key : ints)
+    {
+      assert (key % 14 == 7);
+      ++seen;
+    }
+  assert (seen == 500);
+  vl_hash_set<int> same (ints.begin (), ints.end ());
+  assert (same == ints);
+  same.erase (same.find (7));
+  assert (same != ints && same.find (7) == same.end ());
+  ints.clear ();
+  assert (ints.empty () && ints.begin () == ints.end ());
+}
+
+int main ()
+{
+  test_erase_releases ();
+  test_insert_own_value ();
+  test_set ();
+  return 0;
+}
@@ -0,0 +1,134 @@
+// Smoke tests for the thread pool and the parallel paths, meant to run
+// under the sanitizers (thread, or address and undefined):
+//   g++ -std=c++17 -g -pthread -fsanitize=thread -I.. test_vl_parallel.cpp
+// The pool has 4 workers whatever the machine, so the work is split.
+#define PARALLEL_THREADS 4
+#include "../vl_parallel.h"
+#include <cassert>
+#include <mutex>
+#include <vector>
+
+struct element {
+  long a, b, c; // 24 bytes, which doesn't divide a page.
+
+  bool operator== (const element &rhs) const
+  {
+    return a == rhs.a && b == rhs.b && c == rhs.c;
+  }
+};
+
+/**
+ * The chunks of a split copy cover the elements once, and every chunk but
+ * the first starts at the first element on or after a page boundary.
+ */
+void test_chunk_boundaries ()
+{
+  vl_parallel_settings () = {(size_t) 1 << 16, true, 0};
+  std::vector<element> dst (1000003);
+  std::mutex lock;
+  std::vector<std::pair<size_t, size_t>> chunks;
+  vl_parallel_chunks (dst.data (), dst.size (), [&] (size_t first,
+                                                     size_t count) {
+    std::lock_guard<std::mutex> guard (lock);
+    chunks.emplace_back (first, count);
+  });
+  std::sort (chunks.begin (), chunks.end ());
+  assert (chunks.size () == vl_thread_pool::instance ().size ());
+  size_t next = 0;
+  for (const std::pair<size_t, size_t> &chunk : chunks)
+    {
+      assert (chunk.first == next);
+      if (chunk.first != 0)
+        {
+          const uintptr_t first = (uintptr_t) (dst.data () + chunk.first);
+          const uintptr_t before = first - sizeof (element);
+          assert (first / 4096 != before / 4096 || first % 4096 == 0);
+        }
+      next += chunk.second;
+    }
+  assert (next == dst.size ());
+}
+
+/**
+ * @return the chunks a split copy of n longs is run in, with the current
+ *         parallel configuration.
+ */
+std::vector<std::pair<size_t, size_t>> chunks_of (const size_t n)
+{
+  std::vector<long> dst (n);
+  std::mutex lock;
+  std::vector<std::pair<size_t, size_t>> chunks;
+  vl_parallel_chunks (dst.data (), dst.size (), [&] (size_t first,
+                                                     size_t count) {
+    std::lock_guard<std::mutex> guard (lock);
+    chunks.emplace_back (first, count);
+  });
+  std::sort (chunks.begin (), chunks.end ());
+  return chunks;
+}
+
+/**
+ * The thread count of the configuration caps the chunks at run time, and 1
+ * keeps the copy on the calling thread as one chunk.
+ */
+void test_thread_cap ()
+{
+  const size_t n = 1000003;
+  vl_parallel_settings () = {(size_t) 1 << 16, true, 2};
+  assert (chunks_of (n).size () == 2);
+  vl_parallel_settings () = {(size_t) 1 << 16, true, 64};
+  assert (chunks_of (n).size () == vl_thread_pool::instance ().size ());
+  vl_parallel_settings () = {(size_t) 1 << 16, true, 1};
+  const std::vector<std::pair<size_t, size_t>> one = chunks_of (n);
+  assert (one.size () == 1 && one[0].first == 0 && one[0].second == n);
+  const vl_vector<long, 0> longs (n, 5);
+  const vl_vector<long, 0> copy (longs);
+  assert (copy == longs);
+  vl_parallel_settings () = {PARALLEL_THRESHOLD, false, 0};
+}
+
+/**
+ * Split copies and fills, also from inside tasks of the pool itself.
+ */
+void test_split_copies ()
+{
+  vl_parallel_settings () = {(size_t) 1 << 16, true, 0};
+  const vl_vector<element, 0> elements ((size_t) 1 << 18, element{1, 2, 3});
+  const vl_vector<element, 0> copy (elements);
+  assert (copy == elements);
+  vl_vector<long, 0> numbers ((size_t) 1 << 18, 9);
+  vl_parallel::for_each (numbers, [] (long &n) { n += 1; });
+  vl_thread_pool::instance ().run (8, [&numbers] (size_t) {
+    const vl_vector<long, 0> nested (numbers);
+    assert (nested[12345] == 10 && nested.size () == numbers.size ());
+  });
+  vl_parallel_settings () = {PARALLEL_THRESHOLD, false, 0};
+}
+
+/**
+ * Scans of int into long long accumulate in long long, for sizes that are
+ * scanned serially and in chunks alike.
+ */
+void test_scan_widens ()
+{
+  const int big = 1 << 30;
+  for (const size_t n : {(size_t) 5, PARALLEL_CUTOFF * 3 + 7})
+    {
+      const vl_vector<int, 0> in (n, big);
+      vl_vector<long long, 0> out (n);
+      vl_parallel::inclusive_scan (in, out);
+      for (size_t i = 0; i < n; ++i)
+        {
+          assert (out[i] == (long long) big * (long long) (i + 1));
+        }
+    }
+}
+
+int main ()
+{
+  test_chunk_boundaries ();
+  test_thread_cap ();
+  test_split_copies ();
+  test_scan_widens ();
+  return 0;
+}
@@ -0,0 +1,125 @@
+// Smoke tests for the sorted set operations, meant to run under the
+// sanitizers:
+//   g++ -std=c++17 -g -Wall -Wextra -Wpedantic -fsanitize=address,undefined
+//       -I.. test_vl_set_ops.cpp
+// and again with -DSET_SIMD_UNION=1 for the SSE2 merge of unions.
+#include "../vl_set_ops.h"
+#include "../vl_vector.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <random>
+#include <vector>
+
+/**
+ * @param n Number of elements.
+ * @param range The elements are drawn from [0, range).
+ * @param random The generator.
+ * @return A sorted set of about n elements.
+ */
+template<typename Vector>
+Vector random_set (const size_t n, const unsigned range, std::mt19937 &random)
+{
+  using T = typename Vector::value_type;
+  std::vector<T> elements (n);
+  for (T &x : elements)
+    {
+      x = (T) (random () % range);
+    }
+  std::sort (elements.begin (), elements.end ());
+  elements.erase (std::unique (elements.begin (), elements.end ()),
+                  elements.end ());
+  return Vector (elements.begin (), elements.end ());
+}
+
+/**
+ * Checks all three operations against std::set_*, appending to a vector
+ * that already has an element, and writing into a and into b.
+ * @param a A sorted set.
+ * @param b Another sorted set.
+ */
+template<typename Vector>
+void check (const Vector &a, const Vector &b)
+{
+  using T = typename Vector::value_type;
+  std::vector<T> expected[3];
+  std::set_intersection (a.begin (), a.end (), b.begin (), b.end (),
+                         std::back_inserter (expected[0]));
+  std::set_union (a.begin (), a.end (), b.begin (), b.end (),
+                  std::back_inserter (expected[1]));
+  std::set_difference (a.begin (), a.end (), b.begin (), b.end (),
+                       std::back_inserter (expected[2]));
+  const auto run = [] (const int op, const Vector &x, const Vector &y,
+                       Vector &dst) {
+    if (op == 0)
+      {
+        vl_set_intersect (x, y, dst);
+      }
+    else if (op == 1)
+      {
+        vl_set_union (x, y, dst);
+      }
+    else
+      {
+        vl_set_difference (x, y, dst);
+      }
+  };
+  for (int op = 0; op < 3; ++op)
+    {
+      Vector dst;
+      dst.push_back ((T) 7);
+      run (op, a, b, dst);
+      assert (dst.size () == expected[op].size () + 1 && dst[0] == (T) 7);
+      assert (std::equal (expected[op].begin (), expected[op].end (),
+                          dst.begin () + 1));
+      Vector into_a (a);
+      run (op, into_a, b, into_a);
+      assert (into_a.size () == a.size () + expected[op].size ());
+      assert (std::equal (expected[op].begin (), expected[op].end (),
+                          into_a.begin () + a.size ()));
+      Vector into_b (b);
+      run (op, a, into_b, into_b);
+      assert (std::equal (expected[op].begin (), expected[op].end (),
+                          into_b.begin () + b.size ()));
+    }
+}
+
+/**
+ * Similar sizes take the SIMD or merge paths, and skewed sizes gallop, in
+ * either order.
+ */
+template<typename Vector>
+void test_ratios ()
+{
+  std::mt19937 random (1);
+  const size_t large = 1 << 15;
+  for (const size_t ratio : {1, 64, 1024})
+    {
+      for (const unsigned range : {1u << 16, 1u << 20})
+        {
+          const Vector a = random_set<Vector> (large / ratio, range, random);
+          const Vector b = random_set<Vector> (large, range, random);
+          check (a, b);
+          check (b, a);
+        }
+    }
+  const Vector empty;
+  const Vector some = random_set<Vector> (100, 1000, random);
+  check (empty, some);
+  check (some, empty);
+  check (some, some);
+  for (size_t n = 0; n < 12; ++n)
+    {
+      check (random_set<Vector> (n, 16, random),
+             random_set<Vector> (n + 3, 16, random));
+    }
+}
+
+int main ()
+{
+  test_ratios<vl_vector<uint32_t, 0>> ();
+  test_ratios<vl_vector<uint32_t>> ();
+  test_ratios<vl_vector<int32_t>> ();
+  test_ratios<vl_vector<double>> ();
+  return 0;
+}
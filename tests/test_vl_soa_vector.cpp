@@ -0,0 +1,53 @@
+// Smoke tests for vl_soa_vector, meant to run under the sanitizers:
+//   g++ -std=c++17 -g -Wall -Wextra -Wpedantic -fsanitize=address,undefined
+//       -I.. test_vl_soa_vector.cpp
+#include "../vl_soa_vector.h"
+#include <algorithm>
+#include <cassert>
+
+/**
+ * The iterator has all the operations of a random access iterator, so the
+ * algorithms that bisect a range work on it.
+ */
+void test_random_access ()
+{
+  vl_soa_vector<int, double> v;
+  for (int i = 0; i < 100; ++i)
+    {
+      v.push_back (2 * i, i * 0.5);
+    }
+  auto first = v.begin ();
+  auto last = v.end ();
+  assert (last - first == 100);
+  assert (2 + first == first + 2 && (*(2 + first)).get<0> () == 4);
+  assert (first < last && last > first && first <= first && last >= last);
+  assert (!(first > last) && !(last <= first));
+  auto it = std::partition_point (first, last, [] (const auto &row) {
+    return row.template get<0> () < 51;
+  });
+  assert (it - first == 26 && (*it).get<1> () == 13.0);
+  vl_soa_vector<int, double>::const_iterator cit = it;
+  assert (cit.index () == 26);
+}
+
+/**
+ * The default vector takes about DEFAULT_STATIC_BYTES, like vl_vector.
+ */
+void test_budget ()
+{
+  static_assert (sizeof (vl_soa_vector<int, float, double>)
+                 <= DEFAULT_STATIC_BYTES, "fits the budget");
+  static_assert (sizeof (vl_soa_vector<char>) <= DEFAULT_STATIC_BYTES,
+                 "fits the budget");
+  static_assert (vl_soa_budget_capacity<DEFAULT_STATIC_BYTES, char[512]> == 1,
+                 "one big row inline");
+  vl_soa_vector<char[512]> big;
+  assert (big.size () == 0);
+}
+
+int main ()
+{
+  test_random_access ();
+  test_budget ();
+  return 0;
+}
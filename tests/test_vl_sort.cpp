@@ -0,0 +1,288 @@
+// Smoke tests for vl_sort_elements and vl_vector::sort and stable_sort,
+// against std::sort, meant to run under the sanitizers:
+//   g++ -std=c++17 -g -Wall -Wextra -Wpedantic -fsanitize=address,undefined
+//       -I.. test_vl_sort.cpp
+#include "../vl_vector.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+/**
+ * @param random The generator.
+ * @return A random value of T, from the whole range of the integers, or
+ *         with a lot of repeats, zeros of both signs, infinities and NaNs
+ *         of both signs for floating point types.
+ */
+template<typename T>
+T random_value (std::mt19937_64 &random)
+{
+  if constexpr (std::is_floating_point<T>::value)
+    {
+      switch (random () % 16)
+        {
+        case 0:
+          return (T) -0.0;
+        case 1:
+          return (T) 0.0;
+        case 2:
+          return std::numeric_limits<T>::infinity ();
+        case 3:
+          return -std::numeric_limits<T>::infinity ();
+        case 4:
+          return std::numeric_limits<T>::quiet_NaN ();
+        case 5:
+          return -std::numeric_limits<T>::quiet_NaN ();
+        case 6:
+          return std::numeric_limits<T>::denorm_min ();
+        default:
+          return (T) ((double) (int64_t) (random () % 2001 - 1000) / 8);
+        }
+    }
+  else
+    {
+      const uint64_t bits = random ();
+      T v;
+      std::memcpy (&v, &bits, sizeof (T));
+      // also a lot of repeats.
+      return (random () % 4 == 0) ? (T) (bits % 5) : v;
+    }
+}
+
+/**
+ * @param a A value.
+ * @param b Another value.
+ * @return true if a and b are the same value: equal, or both NaN with the
+ *         same sign.
+ */
+template<typename T>
+bool same (const T a, const T b)
+{
+  if constexpr (std::is_floating_point<T>::value)
+    {
+      if (std::isnan (a) || std::isnan (b))
+        {
+          return std::isnan (a) && std::isnan (b)
+                 && std::signbit (a) == std::signbit (b);
+        }
+    }
+  return a == b;
+}
+
+/**
+ * @param in Some elements.
+ * @return The elements sorted by std::sort, except for the NaNs, which
+ *         std::sort doesn't order: negative NaNs go first, and positive
+ *         NaNs last.
+ */
+template<typename T>
+std::vector<T> expected_sort (const std::vector<T> &in)
+{
+  std::vector<T> numbers;
+  std::vector<T> negative_nans;
+  std::vector<T> positive_nans;
+  for (const T v : in)
+    {
+      if constexpr (std::is_floating_point<T>::value)
+        {
+          if (std::isnan (v))
+            {
+              (std::signbit (v) ? negative_nans : positive_nans).push_back (v);
+              continue;
+            }
+        }
+      numbers.push_back (v);
+    }
+  std::sort (numbers.begin (), numbers.end ());
+  negative_nans.insert (negative_nans.end (), numbers.begin (),
+                        numbers.end ());
+  negative_nans.insert (negative_nans.end (), positive_nans.begin (),
+                        positive_nans.end ());
+  return negative_nans;
+}
+
+/**
+ * @param v A sorted range.
+ * @param expected What it should be.
+ * @return true if v holds the same values as expected.
+ */
+template<typename Range, typename T>
+bool sorted_as (const Range &v, const std::vector<T> &expected)
+{
+  return (size_t) (v.end () - v.begin ()) == expected.size ()
+         && std::equal (v.begin (), v.end (), expected.begin (), same<T>);
+}
+
+/**
+ * Sorts random elements of T, at the sizes of the sorting networks, around
+ * the radix sort threshold, and larger, with vl_sort_elements and with
+ * both vector methods, taking the spare capacity as scratch memory, or
+ * allocating it.
+ */
+template<typename T>
+void test_type ()
+{
+  std::mt19937_64 random (sizeof (T));
+  for (const size_t n : {0, 1, 2, 3, 7, 15, 16, 17, 31, 255, 256, 257, 1000,
+                         5000})
+    {
+      std::vector<T> in (n);
+      for (T &x : in)
+        {
+          x = random_value<T> (random);
+        }
+      const std::vector<T> expected = expected_sort (in);
+
+      std::vector<T> elements (in);
+      vl_sort_elements (elements.data (), n, (T *) nullptr, 0, false);
+      assert (sorted_as (elements, expected));
+      elements = in;
+      vl_sort_elements (elements.data (), n, (T *) nullptr, 0, true);
+      assert (sorted_as (elements, expected));
+
+      // the spare capacity can hold a copy of the elements.
+      vl_vector<T, 0> spare;
+      spare.reserve (2 * n);
+      spare.insert (spare.end (), in.begin (), in.end ());
+      assert (spare.capacity () - spare.size () >= n);
+      spare.sort ();
+      assert (sorted_as (spare, expected));
+      // the spare capacity is too small, so scratch memory is allocated.
+      vl_vector<T, 0> exact;
+      exact.reserve (n);
+      exact.insert (exact.end (), in.begin (), in.end ());
+      assert (exact.capacity () - exact.size () < n || n == 0);
+      exact.stable_sort ();
+      assert (sorted_as (exact, expected));
+      // inline, then on the heap.
+      vl_vector<T> vector (in.begin (), in.end ());
+      vector.sort ();
+      assert (sorted_as (vector, expected));
+      vl_vector<T> stable (in.begin (), in.end ());
+      stable.stable_sort ();
+      assert (sorted_as (stable, expected));
+    }
+}
+
+/**
+ * Every sorting network, from 0 to SORT_NETWORK_MAX elements, sorts all
+ * inputs of zeros and ones, which by the 0-1 principle means it sorts
+ * everything, and random ones of T as std::sort does.
+ */
+template<typename T>
+void test_networks ()
+{
+  std::mt19937_64 random (7);
+  for (size_t n = 0; n <= SORT_NETWORK_MAX; ++n)
+    {
+      T v[SORT_NETWORK_MAX];
+      for (uint32_t bits = 0; bits < ((uint32_t) 1 << n); ++bits)
+        {
+          for (size_t i = 0; i < n; ++i)
+            {
+              v[i] = (T) ((bits >> i) & 1);
+            }
+          assert (vl_network_sort (
+              v, n, std::make_index_sequence<SORT_NETWORK_MAX + 1> ()));
+          const uint32_t ones = (uint32_t) __builtin_popcount (bits);
+          for (size_t i = 0; i < n; ++i)
+            {
+              assert (v[i] == (T) (i >= n - ones));
+            }
+        }
+      for (int round = 0; round < 200; ++round)
+        {
+          std::vector<T> in (n);
+          for (T &x : in)
+            {
+              x = random_value<T> (random);
+              if constexpr (std::is_floating_point<T>::value)
+                {
+                  x = std::isnan (x) ? (T) 1 : x;
+                }
+            }
+          std::vector<T> expected (in);
+          std::sort (expected.begin (), expected.end ());
+          std::copy (in.begin (), in.end (), v);
+          assert (vl_network_sort (
+              v, n, std::make_index_sequence<SORT_NETWORK_MAX + 1> ()));
+          assert (std::equal (v, v + n, expected.begin ()));
+          // zeros of both signs are moved, never copied over each other.
+          assert (std::count_if (v, v + n, [] (T x) {
+            return std::signbit (x);
+          }) == std::count_if (in.begin (), in.end (), [] (T x) {
+            return std::signbit (x);
+          }));
+        }
+    }
+  // a NaN leaves the elements to the other paths.
+  if constexpr (std::is_floating_point<T>::value)
+    {
+      T v[3] = {2, std::numeric_limits<T>::quiet_NaN (), 1};
+      assert (!vl_network_sort (
+          v, 3, std::make_index_sequence<SORT_NETWORK_MAX + 1> ()));
+      assert (v[0] == 2 && std::isnan (v[1]) && v[2] == 1);
+    }
+}
+
+/**
+ * stable_sort keeps zero and negative zero, which are equal, in the order
+ * they came in, at network, std::stable_sort and radix sort sizes.
+ */
+template<typename T>
+void test_stable_zeros ()
+{
+  std::mt19937_64 random (3);
+  for (const size_t n : {2, 5, 16, 17, 100, 256, 1000, 5000})
+    {
+      vl_vector<T, 0> v;
+      std::vector<bool> signs;
+      for (size_t i = 0; i < n; ++i)
+        {
+          const bool zero = (random () % 2 == 0);
+          const bool negative = (random () % 2 == 0);
+          // the other elements are never zero.
+          v.push_back (zero ? (negative ? (T) -0.0 : (T) 0.0)
+                            : (T) (random () % 50 + 1) * (negative ? -1 : 1));
+          if (zero)
+            {
+              signs.push_back (negative);
+            }
+        }
+      v.stable_sort ();
+      std::vector<bool> sorted_signs;
+      for (const T x : v)
+        {
+          if (x == 0)
+            {
+              sorted_signs.push_back (std::signbit (x));
+            }
+        }
+      assert (sorted_signs == signs);
+      assert (std::is_sorted (v.begin (), v.end ()));
+    }
+}
+
+int main ()
+{
+  test_type<int8_t> ();
+  test_type<int16_t> ();
+  test_type<int32_t> ();
+  test_type<int64_t> ();
+  test_type<uint8_t> ();
+  test_type<uint16_t> ();
+  test_type<uint32_t> ();
+  test_type<uint64_t> ();
+  test_type<float> ();
+  test_type<double> ();
+  test_networks<int> ();
+  test_networks<unsigned> ();
+  test_networks<float> ();
+  test_networks<double> ();
+  test_stable_zeros<float> ();
+  test_stable_zeros<double> ();
+  return 0;
+}
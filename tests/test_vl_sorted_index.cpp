@@ -0,0 +1,97 @@
+// Smoke tests for vl_sorted_index and vl_vector::lower_bound, against
+// std::lower_bound, meant to run under the sanitizers:
+//   g++ -std=c++17 -g -Wall -Wextra -Wpedantic -fsanitize=address,undefined
+//       -I.. test_vl_sorted_index.cpp
+#include "../vl_sorted_index.h"
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Checks both searches for a key against std::lower_bound on data ().
+ * @param v A sorted vector.
+ * @param index The index of v.
+ * @param key A key to search for.
+ */
+template<typename Vector, typename T>
+void check (const Vector &v, const vl_sorted_index<T> &index, const T &key)
+{
+  const size_t expected =
+      std::lower_bound (v.data (), v.data () + v.size (), key) - v.data ();
+  assert ((size_t) (v.lower_bound (key) - v.begin ()) == expected);
+  assert (index.lower_bound (key) == expected);
+  assert (index.contains (key)
+          == (expected < v.size () && !(key < v.data ()[expected])));
+}
+
+/**
+ * Empty ranges, sizes around and between the perfect trees of 2^k - 1
+ * nodes, with and without duplicates, and keys before, between, on and past
+ * the elements.
+ */
+void test_sizes ()
+{
+  std::mt19937 random (1);
+  for (size_t n = 0; n < 300; n += (n < 70) ? 1 : 37)
+    {
+      for (const int spread : {1, 3, 100})
+        {
+          // spread 1 makes runs of duplicates.
+          vl_vector<int, 0> v;
+          for (size_t i = 0; i < n; ++i)
+            {
+              v.push_back ((int) (random () % (n * spread / 3 + 1)) * 2);
+            }
+          std::sort (v.begin (), v.end ());
+          const vl_sorted_index<int> index (v.data (), v.data () + n);
+          assert (index.size () == n && index.empty () == (n == 0));
+          const int largest = (n == 0) ? 0 : v[n - 1];
+          for (int key = -3; key <= largest + 3; ++key)
+            {
+              check (v, index, key);
+            }
+          check (v, index, -1000000);
+          check (v, index, 1000000);
+        }
+    }
+}
+
+/**
+ * The vector stays inline, and the index copies keys that aren't
+ * arithmetic.
+ */
+void test_types ()
+{
+  vl_vector<int> inline_ints;
+  for (const int x : {1, 1, 2, 5, 8, 8, 8})
+    {
+      inline_ints.push_back (x);
+    }
+  const vl_sorted_index<int> ints (inline_ints.data (),
+                                   inline_ints.data () + inline_ints.size ());
+  for (int key = 0; key < 10; ++key)
+    {
+      check (inline_ints, ints, key);
+    }
+  vl_vector<std::string, 0> words;
+  for (const char *word : {"a", "ab", "b", "b", "bc", "c", "d", "dd", "e",
+                           "f"})
+    {
+      words.push_back (word);
+    }
+  const vl_sorted_index<std::string> index (words.data (),
+                                            words.data () + words.size ());
+  for (const char *key : {"", "a", "aa", "b", "ba", "c", "de", "f", "g"})
+    {
+      check (words, index, std::string (key));
+    }
+}
+
+int main ()
+{
+  test_sizes ();
+  test_types ();
+  return 0;
+}
@@ -0,0 +1,139 @@
+// Smoke tests for split, split_into and tokenize, meant to run under the
+// sanitizers:
+//   g++ -std=c++17 -g -Wall -Wextra -Wpedantic -fsanitize=address,undefined
+//       -I.. test_vl_split.cpp
+#include "../vl_string.h"
+#include <cassert>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @param range A range of string views.
+ * @return its elements.
+ */
+template<typename Range>
+std::vector<std::string_view> collect (const Range &range)
+{
+  std::vector<std::string_view> out;
+  for (std::string_view s : range)
+    {
+      out.push_back (s);
+    }
+  return out;
+}
+
+/**
+ * @param s A string.
+ * @param delims The delimiter characters.
+ * @return The non-empty tokens of s, found a character at a time.
+ */
+std::vector<std::string_view> reference_tokens (std::string_view s,
+                                                std::string_view delims)
+{
+  std::vector<std::string_view> out;
+  size_t first = 0;
+  for (size_t i = 0; i <= s.size (); ++i)
+    {
+      if (i == s.size () || delims.find (s[i]) != std::string_view::npos)
+        {
+          if (i > first)
+            {
+              out.push_back (s.substr (first, i - first));
+            }
+          first = i + 1;
+        }
+    }
+  return out;
+}
+
+/**
+ * CSV and TSV lines keep their empty fields, including leading and
+ * trailing ones, and an empty string is one empty field.
+ */
+void test_split ()
+{
+  using fields = std::vector<std::string_view>;
+  assert (collect (vl_split_range ("a,b,c", ',')) == (fields{"a", "b", "c"}));
+  assert (collect (vl_split_range ("a,,c", ',')) == (fields{"a", "", "c"}));
+  assert (collect (vl_split_range (",a,", ',')) == (fields{"", "a", ""}));
+  assert (collect (vl_split_range (",,", ',')) == (fields{"", "", ""}));
+  assert (collect (vl_split_range ("1\t\t3\t", '\t'))
+          == (fields{"1", "", "3", ""}));
+  assert (collect (vl_split_range ("no delimiter", ','))
+          == (fields{"no delimiter"}));
+  assert (collect (vl_split_range ("", ',')) == (fields{""}));
+  assert (collect (vl_split_range (std::string_view (), ',')) == (fields{""}));
+  const vl_string<> line ("x,,y,");
+  assert (collect (line.split (',')) == (fields{"x", "", "y", ""}));
+  assert (collect (vl_string<> ().split (',')) == (fields{""}));
+}
+
+/**
+ * split_into appends the fields, as views into the string, to vectors of
+ * any capacity, past the ones they already hold.
+ */
+void test_split_into ()
+{
+  const vl_string<> line (",id,,name,");
+  vl_vector<std::string_view, 2> small;
+  small.push_back ("before");
+  assert (line.split_into (small, ',') == 5);
+  assert (small.size () == 6 && small[0] == "before");
+  assert (small[1] == "" && small[2] == "id" && small[3] == ""
+          && small[4] == "name" && small[5] == "");
+  assert (small[2].data () == line.data () + 1);
+  const vl_string<> tsv ("a\tb");
+  const vl_string<> empty;
+  vl_vector<std::string_view, 1> heap;
+  assert (tsv.split_into (heap, '\t') == 2);
+  assert (empty.split_into (heap, '\t') == 1);
+  assert (heap.size () == 3 && heap[1] == "b" && heap[2] == "");
+}
+
+/**
+ * Tokens against a reference, for sets scanned with SSE2 and with the
+ * table, with delimiters on both sides of the 16 byte blocks, runs of them,
+ * and characters above 127.
+ */
+void test_tokenize ()
+{
+  using tokens = std::vector<std::string_view>;
+  assert (collect (vl_token_range ("  a b  c ", " "))
+          == (tokens{"a", "b", "c"}));
+  assert (collect (vl_token_range ("", " ")).empty ());
+  assert (collect (vl_token_range (std::string_view (), " ")).empty ());
+  assert (collect (vl_token_range (" ,; ", " ,;")).empty ());
+  assert (collect (vl_token_range ("abc", "")) == (tokens{"abc"}));
+  const vl_string<> text ("one, two;three");
+  assert (collect (text.tokenize (" ,;")) == (tokens{"one", "two", "three"}));
+
+  std::mt19937 random (1);
+  const char alphabet[] = "ab ,;\t\xff|-x";
+  for (const std::string_view delims : {" ", " ,", " ,;\t", ",,,  ",
+                                        "\xff", " ,;\t|", " ,;\t|-x"})
+    {
+      for (size_t n = 0; n < 200; n += 1 + n / 8)
+        {
+          for (int round = 0; round < 20; ++round)
+            {
+              std::string s (n, ' ');
+              for (char &c : s)
+                {
+                  c = alphabet[random () % (sizeof (alphabet) - 1)];
+                }
+              assert (collect (vl_token_range (s, delims))
+                      == reference_tokens (s, delims));
+            }
+        }
+    }
+}
+
+int main ()
+{
+  test_split ();
+  test_split_into ();
+  test_tokenize ();
+  return 0;
+}
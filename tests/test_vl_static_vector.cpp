@@ -0,0 +1,107 @@
+// Smoke tests for vl_static_vector, meant to run under the sanitizers:
+//   g++ -std=c++17 -g -Wall -Wextra -Wpedantic -fsanitize=address,undefined
+//       -I.. test_vl_static_vector.cpp
+#include "../vl_static_vector.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <string>
+
+/**
+ * An element whose copy and move assignments may throw.
+ */
+struct throwing {
+  int value = 0;
+  throwing &operator= (const throwing &rhs) noexcept (false)
+  {
+    value = rhs.value;
+    return *this;
+  }
+  throwing &operator= (throwing &&rhs) noexcept (false)
+  {
+    value = rhs.value;
+    return *this;
+  }
+};
+
+/**
+ * push and erase are noexcept only when assigning T is.
+ */
+void test_noexcept ()
+{
+  vl_static_vector<int, 4> ints;
+  vl_static_vector<throwing, 4> throwings;
+  static_assert (noexcept (ints.try_push_back (1)), "int can't throw");
+  static_assert (noexcept (ints.unchecked_push_back (1)), "int can't throw");
+  static_assert (noexcept (ints.erase (ints.begin ())), "int can't throw");
+  static_assert (!noexcept (throwings.try_push_back (throwing{})),
+                 "throwing copy");
+  static_assert (!noexcept (throwings.unchecked_push_back (throwing{})),
+                 "throwing copy");
+  static_assert (!noexcept (throwings.erase (throwings.begin ())),
+                 "throwing move");
+}
+
+/**
+ * A vector of a trivially copyable type can be copied with memcpy.
+ */
+void test_trivially_copyable ()
+{
+  static_assert (std::is_trivially_copyable<vl_static_vector<int, 8>>::value,
+                 "trivially copyable like int");
+  static_assert (
+      !std::is_trivially_copyable<vl_static_vector<std::string, 8>>::value,
+      "not trivially copyable like std::string");
+  vl_static_vector<int, 8> v;
+  for (int i = 0; i < 8; ++i)
+    {
+      assert (v.try_push_back (i));
+    }
+  assert (!v.try_push_back (8));
+  vl_static_vector<int, 8> copy;
+  std::memcpy (static_cast<void *> (&copy), &v, sizeof (v));
+  assert (copy == v);
+  assert (*copy.crbegin () == 7 && copy.crend () - copy.crbegin () == 8);
+}
+
+/**
+ * @param v A vector.
+ * @param expected The elements it should have.
+ * @return true if v has exactly the expected elements, otherwise false.
+ */
+template<size_t N>
+bool equals (const vl_static_vector<int, 16> &v, const int (&expected)[N])
+{
+  return v.size () == N && std::equal (v.begin (), v.end (), expected);
+}
+
+/**
+ * Inserting elements of the vector into itself, which shifts them.
+ */
+void test_self_insert ()
+{
+  const int init[] = {1, 2, 3};
+  vl_static_vector<int, 16> v (init, init + 3);
+  v.insert (v.begin (), v[2]);
+  const int one[] = {3, 1, 2, 3};
+  assert (equals (v, one));
+  v.insert (v.begin () + 1, v.begin (), v.end ());
+  const int all[] = {3, 3, 1, 2, 3, 1, 2, 3};
+  assert (equals (v, all));
+  v.insert (v.begin () + 2, v.begin () + 1, v.begin () + 4);
+  const int straddling[] = {3, 3, 3, 1, 2, 1, 2, 3, 1, 2, 3};
+  assert (equals (v, straddling));
+  vl_static_vector<std::string, 4> strings;
+  strings.push_back ("a");
+  strings.push_back ("b");
+  strings.insert (strings.begin (), strings[1]);
+  assert (strings[0] == "b" && strings[1] == "a" && strings[2] == "b");
+}
+
+int main ()
+{
+  test_noexcept ();
+  test_trivially_copyable ();
+  test_self_insert ();
+  return 0;
+}
@@ -0,0 +1,134 @@
+// Smoke tests for vl_string, meant to run under the sanitizers:
+//   g++ -std=c++17 -g -fsanitize=address,undefined -I.. test_vl_string.cpp
+#include "../vl_string.h"
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+/**
+ * vl_strings of different static capacities convert, compare and
+ * concatenate with each other.
+ */
+void test_cross_capacity ()
+{
+  const vl_string<4> small ("hello world");
+  vl_string<> a (small);
+  vl_string<> b = small;
+  assert (a == small && small == b && !(a != small));
+  a = small;
+  a += small;
+  a.append (small);
+  const vl_string<> c = b + small;
+  assert (a == "hello worldhello worldhello world");
+  assert (c == std::string_view ("hello worldhello world"));
+  assert (small != c);
+}
+
+/**
+ * Comparing with strings and string views from either side.
+ */
+void test_compare ()
+{
+  const vl_string<> s ("abc");
+  assert (s == "abc" && "abc" == s);
+  assert (s == std::string_view ("abc") && std::string_view ("abc") == s);
+  assert (s != "abd" && std::string_view ("ab") != s);
+  assert (std::string_view (s).size () == 3);
+}
+
+/**
+ * Numbers are appended with only the characters they take, so a string
+ * that is one character short of its static capacity stays on the stack,
+ * and a long run of them grows the string like any other append.
+ */
+void test_append_number ()
+{
+  vl_string<8> s ("ab");
+  s.append_int (-12).append_uint (3);
+  assert (s == "ab-123" && s.capacity () == 8);
+  s.append_int (4);
+  assert (s == "ab-1234" && s.capacity () == 8 && s.data ()[7] == '\0');
+
+  vl_string<> limits;
+  limits.append_int (std::numeric_limits<long long>::min ()) += ' ';
+  limits.append_int (std::numeric_limits<long long>::max ()) += ' ';
+  limits.append_uint (std::numeric_limits<unsigned long long>::max ());
+  assert (limits == "-9223372036854775808 9223372036854775807 "
+                    "18446744073709551615");
+
+  vl_string<> doubles;
+  doubles.append_double (0.1) += ' ';
+  doubles.append_double (-0.0) += ' ';
+  doubles.append_double (1e300) += ' ';
+  doubles.append_double (std::numeric_limits<double>::infinity ()) += ' ';
+  doubles.append_double (-std::numeric_limits<double>::denorm_min ());
+  assert (doubles == "0.1 -0 1e+300 inf -5e-324");
+
+  // the longest shortest form of a double round trips.
+  vl_string<> longest;
+  longest.append_double (-2.2250738585072014e-308);
+  assert (longest == "-2.2250738585072014e-308");
+  assert (longest.parse<double> () == -2.2250738585072014e-308);
+
+  vl_string<4> many;
+  std::string expected;
+  for (int i = -500; i < 500; ++i)
+    {
+      many.append_int (i);
+      expected += std::to_string (i);
+    }
+  assert (many == std::string_view (expected));
+}
+
+/**
+ * parse takes the whole string, and tells numbers that don't fit from
+ * strings that aren't numbers.
+ */
+void test_parse ()
+{
+  assert (vl_string<> ("-42").parse<int> () == -42);
+  assert (vl_string<> ("255").parse<unsigned char> () == 255);
+  assert (vl_string<> ("1e-3").parse<double> () == 1e-3);
+  assert (std::isinf (vl_string<> ("inf").parse<double> ()));
+  for (const char *out_of_range : {"256", "99999999999999999999"})
+    {
+      try
+        {
+          vl_string<> (out_of_range).parse<unsigned char> ();
+          assert (false);
+        }
+      catch (const std::out_of_range &)
+        {
+        }
+    }
+  for (const char *invalid : {"", "abc", "12abc", " 12", "12 ", "+1", "-1"})
+    {
+      try
+        {
+          vl_string<> (invalid).parse<unsigned> ();
+          assert (false);
+        }
+      catch (const std::invalid_argument &)
+        {
+        }
+    }
+  try
+    {
+      vl_string<> ("1e999").parse<double> ();
+      assert (false);
+    }
+  catch (const std::out_of_range &)
+    {
+    }
+}
+
+int main ()
+{
+  test_cross_capacity ();
+  test_compare ();
+  test_append_number ();
+  test_parse ();
+  return 0;
+}
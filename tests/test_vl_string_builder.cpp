@@ -0,0 +1,104 @@
+// Smoke tests for vl_string_builder, meant to run under the sanitizers:
+//   g++ -std=c++17 -g -Wall -Wextra -Wpedantic -fsanitize=address,undefined
+//       -I.. test_vl_string_builder.cpp
+#include "../vl_string_builder.h"
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+// number of aligned heap allocations, which is how vl_vector allocates.
+size_t allocations = 0;
+
+void *operator new (size_t bytes, std::align_val_t alignment)
+{
+  ++allocations;
+  const size_t align = (size_t) alignment;
+  void *p = std::aligned_alloc (align, (bytes + align - 1) / align * align);
+  if (p == nullptr)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+void operator delete (void *p, std::align_val_t) noexcept
+{
+  std::free (p);
+}
+
+void operator delete (void *p, size_t, std::align_val_t) noexcept
+{
+  std::free (p);
+}
+
+/**
+ * Every operator<< overload, chained.
+ */
+void test_append ()
+{
+  const vl_string<4> other ("vl");
+  const char *str = "str";
+  vl_string_builder<64> b;
+  assert (b.empty ());
+  b << 'c' << ' ' << str << ' ' << std::string_view ("view") << ' ' << other
+    << ' ' << vl_string<> ("string") << ' ' << true << ' ' << false;
+  assert (b.size () == 31 && !b.empty ());
+  b << ' ' << 0 << ' ' << -42 << ' ' << (short) -7 << ' ' << 42u << ' '
+    << std::numeric_limits<long long>::min () << ' '
+    << std::numeric_limits<unsigned long long>::max () << ' '
+    << (signed char) 65 << ' ' << (unsigned char) 200;
+  b << ' ' << 0.5 << ' ' << -1e-300 << ' ' << 0.1f << ' ' << 2.0;
+  b.append ("!?", 1);
+  const vl_string<64> s = b.finish ();
+  assert (s == "c str view vl string true false 0 -42 -7 42 "
+               "-9223372036854775808 18446744073709551615 65 200 "
+               "0.5 -1e-300 0.1 2!");
+}
+
+/**
+ * finish () hands the characters to the string by move: on the stack they
+ * are copied into the string's own stack buffer, and on the heap the
+ * string takes over the buffer without another allocation. Either way the
+ * builder is left empty and can build again.
+ */
+void test_finish ()
+{
+  vl_string_builder<16> stack;
+  stack << "on the " << "stack";
+  const size_t before_stack = allocations;
+  const vl_string<16> small = stack.finish ();
+  assert (allocations == before_stack);
+  assert (small == "on the stack" && small.capacity () == 16);
+  assert (stack.empty () && stack.size () == 0);
+  stack << 1 << '2';
+  assert (stack.finish () == "12");
+
+  vl_string_builder<16> heap;
+  const size_t before_build = allocations;
+  for (int i = 0; i < 100; ++i)
+    {
+      heap << (char) ('a' + i % 26);
+    }
+  const size_t before_heap = allocations;
+  assert (before_heap > before_build);
+  const vl_string<16> large = heap.finish ();
+  assert (allocations == before_heap);
+  assert (large.size () == 100 && large.capacity () > 16);
+  assert (large.data ()[0] == 'a' && large.data ()[99] == 'v');
+  assert (large.data ()[100] == '\0');
+  assert (heap.empty ());
+  heap << "again";
+  assert (heap.finish () == "again");
+
+  vl_string_builder<16> empty;
+  const vl_string<16> none = empty.finish ();
+  assert (none.size () == 0 && none == "");
+}
+
+int main ()
+{
+  test_append ();
+  test_finish ();
+  return 0;
+}
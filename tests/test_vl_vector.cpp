@@ -0,0 +1,266 @@
+// Smoke tests for vl_vector, meant to run under the sanitizers:
+//   g++ -std=c++17 -g -Wall -Wextra -Wpedantic -fsanitize=address,undefined
+//       -I.. test_vl_vector.cpp
+// Huge pages start at 2MiB here, so small vectors take the mremap path.
+#define HUGE_PAGE_THRESHOLD ((size_t) 2 * 1024 * 1024)
+#include "../vl_vector.h"
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Fills v to its capacity, and maps a page right after its memory, so
+ * growing it with mremap has to move it.
+ */
+template<typename Vector>
+void fill_and_block (Vector &v)
+{
+  v.push_back (7);
+  while (v.size () < v.capacity ())
+    {
+      v.push_back ((int) v.size ());
+    }
+#ifdef __linux__
+  char *end = reinterpret_cast<char *> (v.data ())
+              + vl_huge_length (v.capacity () * sizeof (int));
+  void *page = mmap (end, 4096, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS
+                     | MAP_FIXED_NOREPLACE, -1, 0);
+  (void) page;
+#endif
+}
+
+/**
+ * Inserting an element of the vector into itself, while it grows.
+ */
+template<typename Vector>
+void test_self_insert_growing ()
+{
+  Vector v;
+  v.reserve (HUGE_PAGE_THRESHOLD / sizeof (int));
+  fill_and_block (v);
+  const size_t size = v.size ();
+  v.push_back (v[0]);
+  assert (v.size () == size + 1 && v[size] == 7);
+  v.insert (v.begin (), v.end () - 3, v.end ());
+  assert (v[0] == (int) size - 2 && v[1] == (int) size - 1 && v[2] == 7);
+}
+
+/**
+ * Inserting elements of the vector into itself, when there is room.
+ */
+template<typename Vector>
+void test_self_insert_in_place ()
+{
+  Vector v;
+  for (int i = 0; i < 8; ++i)
+    {
+      v.push_back (i);
+    }
+  v.reserve (64);
+  v.insert (v.begin (), v[2]);
+  v.insert (v.begin () + 1, v.begin () + 4, v.begin () + 7);
+  const std::vector<int> expected = {2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+  assert (std::equal (v.begin (), v.end (), expected.begin (),
+                      expected.end ()));
+}
+
+/**
+ * Self inserts of elements that own memory, from the stack and the heap.
+ */
+void test_self_insert_strings ()
+{
+  vl_vector<std::string, 4> v;
+  const std::string s (40, 'x');
+  for (int i = 0; i < 4; ++i)
+    {
+      v.push_back (s);
+    }
+  v.push_back (v[0]);
+  v.insert (v.begin (), v[4]);
+  for (const std::string &e : v)
+    {
+      assert (e == s);
+    }
+}
+
+/**
+ * Bulk copies and fills of elements larger than a streaming store, which
+ * must not instantiate the streaming code.
+ */
+void test_bulk_large_elements ()
+{
+  struct big {
+    char bytes[256];
+  };
+  vl_vector<big> v (10, big{});
+  v.resize (20);
+  const vl_vector<big> copy (v);
+  assert (copy.size () == 20);
+}
+
+/**
+ * @param v A vector of any static capacity.
+ * @return the number of its elements.
+ */
+template<typename T>
+size_t count_elements (const vl_vector_ref<T> &v)
+{
+  return v.size ();
+}
+
+/**
+ * The default vl_vector of an element larger than the byte budget still
+ * has a stack, so it's a vl_vector_ref like any other.
+ */
+void test_budget_of_large_elements ()
+{
+  struct big {
+    char bytes[512];
+  };
+  static_assert (vl_budget_capacity<big> == 1, "one big element inline");
+  vl_vector<big> v (3, big{});
+  assert (count_elements<big> (v) == 3);
+}
+
+/**
+ * The alignment comes from the type, not from every object, so the budget
+ * isn't shrunk by it, and over-aligned heap memory is freed as it was
+ * allocated.
+ */
+void test_alignment_not_stored ()
+{
+  static_assert (vl_budget_capacity<char> == 80, "80 chars inline");
+  static_assert (sizeof (vl_vector<char>) == DEFAULT_STATIC_BYTES,
+                 "the default vector fills the budget");
+  vl_vector<double, 2, 64> a (100, 1.5);
+  vl_vector<double, 2, 64> b (3, 2.5);
+  assert (reinterpret_cast<uintptr_t> (a.data ()) % 64 == 0);
+  b = std::move (a);
+  assert (b.size () == 100 && b[99] == 1.5);
+  vl_vector_ref<double> &ref = b;
+  ref.resize (1000);
+  assert (reinterpret_cast<uintptr_t> (ref.data ()) % 64 == 0);
+}
+
+/**
+ * Only heap memory mapped on huge pages takes hints: advise () is false
+ * for vectors that are inline, on the operator new heap, or empty.
+ */
+void test_advise ()
+{
+  vl_vector<int, 16> inline_ints ((size_t) 10, 1);
+  assert (!inline_ints.advise (MADV_SEQUENTIAL));
+  vl_vector<int, 16> small_heap ((size_t) 1000, 1);
+  assert (!small_heap.advise (MADV_SEQUENTIAL));
+  const vl_vector_ref<int> &ref = small_heap;
+  assert (!ref.advise (MADV_WILLNEED));
+  vl_vector<int, 0> empty;
+  assert (!empty.advise (MADV_SEQUENTIAL));
+  vl_vector<int, 0> heap ((size_t) 1000, 1);
+  assert (!heap.advise (MADV_SEQUENTIAL));
+  const size_t n = HUGE_PAGE_THRESHOLD / sizeof (int);
+  vl_vector<int, 0> huge (n, 1);
+  vl_vector<int, 16> huge_spilled (n, 1);
+#ifdef __linux__
+  assert (huge.advise (MADV_SEQUENTIAL));
+  assert (huge_spilled.advise (MADV_SEQUENTIAL));
+#endif
+  const vl_vector<int, 0> moved (std::move (huge));
+  assert (!huge.advise (MADV_SEQUENTIAL));
+}
+
+/**
+ * Growth near max_size () is clamped to it, and sizes past it throw
+ * std::length_error before anything is allocated.
+ */
+void test_max_size ()
+{
+  for (const size_t max : {(size_t) 100, vl_max_size<char> (),
+                           vl_max_size<int> (), vl_max_size<double> ()})
+    {
+      const size_t at_growth = (size_t) (max / GROWTH_FACTOR);
+      const size_t around = std::min ((size_t) 1000, at_growth / 4);
+      for (const size_t n : {(size_t) 1, at_growth - around, at_growth,
+                             at_growth + around, max - 1, max})
+        {
+          const size_t cap = vl_grow_capacity (n, 0, max);
+          assert (cap >= n && cap <= max);
+          assert (vl_grow_capacity (n / 2, n - n / 2, max) == cap);
+        }
+      assert (vl_grow_capacity (max - 1, 1, max) == max);
+      bool thrown = false;
+      try
+        {
+          vl_grow_capacity (max - 1, 2, max);
+        }
+      catch (const std::length_error &)
+        {
+          thrown = true;
+        }
+      assert (thrown);
+      thrown = false;
+      try
+        {
+          vl_grow_capacity (max + 1, 0, max);
+        }
+      catch (const std::length_error &)
+        {
+          thrown = true;
+        }
+      assert (thrown);
+    }
+  vl_vector<int, 0> heap ((size_t) 3, 1);
+  vl_vector<int> stack ((size_t) 3, 1);
+  int thrown = 0;
+  try
+    {
+      heap.reserve (heap.max_size () + 1);
+    }
+  catch (const std::length_error &)
+    {
+      ++thrown;
+    }
+  try
+    {
+      stack.reserve (stack.max_size () + 1);
+    }
+  catch (const std::length_error &)
+    {
+      ++thrown;
+    }
+  try
+    {
+      stack.resize (stack.max_size () + 1);
+    }
+  catch (const std::length_error &)
+    {
+      ++thrown;
+    }
+  try
+    {
+      heap.resize (heap.max_size () + 1);
+    }
+  catch (const std::length_error &)
+    {
+      ++thrown;
+    }
+  assert (thrown == 4);
+  assert (heap.size () == 3 && stack.size () == 3 && stack[2] == 1);
+}
+
+int main ()
+{
+  test_self_insert_growing<vl_vector<int, 0>> ();
+  test_self_insert_growing<vl_vector<int, 4>> ();
+  test_self_insert_in_place<vl_vector<int, 0>> ();
+  test_self_insert_in_place<vl_vector<int, 4>> ();
+  test_self_insert_strings ();
+  test_bulk_large_elements ();
+  test_budget_of_large_elements ();
+  test_alignment_not_stored ();
+  test_advise ();
+  test_max_size ();
+  return 0;
+}
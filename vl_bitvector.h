@@ -0,0 +1,465 @@
+#ifndef _VL_BITVECTOR_H_
+#define _VL_BITVECTOR_H_
+
+#include "vl_vector.h"
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define BITS_PER_WORD 64
+#define DEFAULT_STATIC_BITS (8 * CACHE_LINE_SIZE)
+
+/**
+ * The bitwise operations that vl_bitvector applies between two vectors.
+ */
+enum class vl_bit_op {
+  AND, OR, XOR, ANDNOT
+};
+
+/**
+ * Applies a bitwise operation word by word: dst = dst op src, where ANDNOT
+ * is dst & ~src. With SSE2 it works on two words at a time.
+ * @tparam Op The operation.
+ * @param dst The words to update.
+ * @param src The words of the other operand.
+ * @param n Number of words.
+ */
+template<vl_bit_op Op>
+void vl_bitwise (uint64_t *dst, const uint64_t *src, const size_t n)
+noexcept (true)
+{
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; i + 2 <= n; i += 2)
+    {
+      __m128i *d = reinterpret_cast<__m128i *> (dst + i);
+      const __m128i a = _mm_loadu_si128 (d);
+      const __m128i b =
+          _mm_loadu_si128 (reinterpret_cast<const __m128i *> (src + i));
+      __m128i r;
+      if constexpr (Op == vl_bit_op::AND)
+        {
+          r = _mm_and_si128 (a, b);
+        }
+      else if constexpr (Op == vl_bit_op::OR)
+        {
+          r = _mm_or_si128 (a, b);
+        }
+      else if constexpr (Op == vl_bit_op::XOR)
+        {
+          r = _mm_xor_si128 (a, b);
+        }
+      else
+        {
+          r = _mm_andnot_si128 (b, a);
+        }
+      _mm_storeu_si128 (d, r);
+    }
+#endif
+  for (; i < n; ++i)
+    {
+      if constexpr (Op == vl_bit_op::AND)
+        {
+          dst[i] &= src[i];
+        }
+      else if constexpr (Op == vl_bit_op::OR)
+        {
+          dst[i] |= src[i];
+        }
+      else if constexpr (Op == vl_bit_op::XOR)
+        {
+          dst[i] ^= src[i];
+        }
+      else
+        {
+          dst[i] &= ~src[i];
+        }
+    }
+}
+
+/**
+ * Represents a Variable Length Vector of bits, packed 64 to a word, so it
+ * takes 8 times less memory than a vector of bool, and counts and searches
+ * a word at a time. The words are held in a vl_vector, so the first N bits
+ * are on the stack, and beyond that they are on the heap. The bits past the
+ * size in the last word are always 0.
+ * @tparam N How much bits can be on the stack.
+ */
+template<const size_t N = DEFAULT_STATIC_BITS>
+class vl_bitvector {
+ public:
+  // how much words can be on the stack.
+  static constexpr size_t StaticWords =
+      (N + BITS_PER_WORD - 1) / BITS_PER_WORD;
+
+ private:
+  /************* Private Fields **************/
+  // the bits, aligned for SIMD loads.
+  vl_vector<uint64_t, StaticWords, 16> _words;
+  size_t _size; // number of bits.
+
+  /************* Private Methods **************/
+
+  /**
+   * @param n Number of bits.
+   * @return The number of words that hold n bits.
+   */
+  static size_t words_for (const size_t n) noexcept (true)
+  {
+    return (n + BITS_PER_WORD - 1) / BITS_PER_WORD;
+  }
+
+  /**
+   * Clears the bits past the size in the last word.
+   */
+  void trim () noexcept (true)
+  {
+    if (_size % BITS_PER_WORD != 0)
+      {
+        _words.data ()[_words.size () - 1] &=
+            ((uint64_t) 1 << (_size % BITS_PER_WORD)) - 1;
+      }
+  }
+
+  /**
+   * Applies a bitwise operation with another vector of the same size.
+   * @tparam Op The operation.
+   * @param rhs Another vector.
+   */
+  template<vl_bit_op Op, const size_t M>
+  void apply (const vl_bitvector<M> &rhs) noexcept (false)
+  {
+    if (rhs.size () != _size)
+      {
+        throw std::invalid_argument{"Sizes differ"};
+      }
+    vl_bitwise<Op> (_words.data (), rhs.data (), _words.size ());
+  }
+
+ public:
+  /************* Constructors **************/
+
+  /**
+   * Initializes the vector with 'count' bits that have the value 'v'.
+   * @param count Number of bits.
+   * @param v The value of the bits.
+   */
+  explicit vl_bitvector (const size_t count = 0, const bool v = false) :
+      _size (0)
+  {
+    resize (count, v);
+  }
+
+  /************* Public Methods **************/
+
+  /**
+   * @return a pointer to the words, with bit i in bit i % 64 of word
+   *         i / 64.
+   */
+  uint64_t *data () noexcept (true)
+  {
+    return _words.data ();
+  }
+
+  /**
+   * @return a const pointer to the words.
+   */
+  const uint64_t *data () const noexcept (true)
+  {
+    return _words.data ();
+  }
+
+  /**
+   * @return the number of words that hold the bits.
+   */
+  size_t word_count () const noexcept (true)
+  {
+    return _words.size ();
+  }
+
+  /**
+   * @return the number of bits in the vector.
+   */
+  size_t size () const noexcept (true)
+  {
+    return _size;
+  }
+
+  /**
+   * @return true if the vector has no bits, otherwise false.
+   */
+  bool empty () const noexcept (true)
+  {
+    return _size == 0;
+  }
+
+  /**
+   * Makes sure the vector can hold at least n bits without another
+   * allocation.
+   * @param n The requested capacity in bits.
+   */
+  void reserve (const size_t n) noexcept (false)
+  {
+    _words.reserve (words_for (n));
+  }
+
+  /**
+   * Changes the number of bits to count, by deleting the last bits or by
+   * adding bits with the value v at the end.
+   * @param count The new number of bits.
+   * @param v The value of the added bits.
+   */
+  void resize (const size_t count, const bool v = false) noexcept (false)
+  {
+    const size_t old_size = _size;
+    _words.resize (words_for (count), v ? ~(uint64_t) 0 : 0);
+    if (v && count > old_size && old_size % BITS_PER_WORD != 0)
+      {
+        _words.data ()[old_size / BITS_PER_WORD] |=
+            ~(uint64_t) 0 << (old_size % BITS_PER_WORD);
+      }
+    _size = count;
+    trim ();
+  }
+
+  /**
+   * Adds a bit to the end of the vector.
+   * @param v The value of the bit.
+   */
+  void push_back (const bool v) noexcept (false)
+  {
+    if (_size % BITS_PER_WORD == 0)
+      {
+        _words.push_back (0);
+      }
+    _words.data ()[_size / BITS_PER_WORD] |=
+        (uint64_t) v << (_size % BITS_PER_WORD);
+    ++_size;
+  }
+
+  /**
+   * Deletes all the bits.
+   */
+  void clear () noexcept (false)
+  {
+    _words.clear ();
+    _size = 0;
+  }
+
+  /**
+   * @param i An index.
+   * @return the bit at index i.
+   */
+  bool test (const size_t i) const noexcept (false)
+  {
+    if (i >= _size)
+      {
+        throw std::out_of_range{"Invalid index"};
+      }
+    return (*this)[i];
+  }
+
+  /**
+   * Sets the bit at index i to v. Unlike test, i isn't checked, except by
+   * an assert in debug builds.
+   * @param i An index, less than size ().
+   * @param v The new value of the bit.
+   */
+  void set (const size_t i, const bool v = true) noexcept (true)
+  {
+    assert (i < _size);
+    uint64_t &word = _words.data ()[i / BITS_PER_WORD];
+    const uint64_t bit = (uint64_t) 1 << (i % BITS_PER_WORD);
+    word = v ? (word | bit) : (word & ~bit);
+  }
+
+  /**
+   * Sets the bit at index i to 0.
+   * @param i An index, less than size ().
+   */
+  void reset (const size_t i) noexcept (true)
+  {
+    assert (i < _size);
+    _words.data ()[i / BITS_PER_WORD] &=
+        ~((uint64_t) 1 << (i % BITS_PER_WORD));
+  }
+
+  /**
+   * Flips the bit at index i.
+   * @param i An index, less than size ().
+   */
+  void flip (const size_t i) noexcept (true)
+  {
+    assert (i < _size);
+    _words.data ()[i / BITS_PER_WORD] ^= (uint64_t) 1 << (i % BITS_PER_WORD);
+  }
+
+  /**
+   * Sets all the bits to v, a word at a time.
+   * @param v The new value of the bits.
+   */
+  void fill (const bool v) noexcept (true)
+  {
+    std::fill_n (_words.data (), _words.size (), v ? ~(uint64_t) 0 : 0);
+    trim ();
+  }
+
+  /**
+   * @return the number of bits that are 1, counted a word at a time.
+   */
+  size_t count () const noexcept (true)
+  {
+    const uint64_t *words = _words.data ();
+    size_t count = 0;
+    for (size_t w = 0; w < _words.size (); ++w)
+      {
+        count += __builtin_popcountll (words[w]);
+      }
+    return count;
+  }
+
+  /**
+   * @return true if any bit is 1, otherwise false.
+   */
+  bool any () const noexcept (true)
+  {
+    return find_first () != _size;
+  }
+
+  /**
+   * @return true if all the bits are 1, otherwise false.
+   */
+  bool all () const noexcept (true)
+  {
+    return count () == _size;
+  }
+
+  /**
+   * @return true if all the bits are 0, otherwise false.
+   */
+  bool none () const noexcept (true)
+  {
+    return !any ();
+  }
+
+  /**
+   * @return the index of the first bit that is 1, or size () if there is
+   *         none.
+   */
+  size_t find_first () const noexcept (true)
+  {
+    return find_next (0);
+  }
+
+  /**
+   * Skips the words that are 0, and finds the bit in a word with a count of
+   * trailing zeros.
+   * @param from An index.
+   * @return the index of the first bit that is 1 from index 'from' onwards,
+   *         or size () if there is none.
+   */
+  size_t find_next (const size_t from) const noexcept (true)
+  {
+    if (from >= _size)
+      {
+        return _size;
+      }
+    const uint64_t *words = _words.data ();
+    size_t w = from / BITS_PER_WORD;
+    uint64_t word = words[w] & (~(uint64_t) 0 << (from % BITS_PER_WORD));
+    while (word == 0)
+      {
+        if (++w == _words.size ())
+          {
+            return _size;
+          }
+        word = words[w];
+      }
+    return w * BITS_PER_WORD + __builtin_ctzll (word);
+  }
+
+  /**
+   * Clears the bits that are 1 in rhs, which is this &= ~rhs in a single
+   * pass.
+   * @param rhs Another vector of the same size.
+   */
+  template<const size_t M>
+  void and_not (const vl_bitvector<M> &rhs) noexcept (false)
+  {
+    apply<vl_bit_op::ANDNOT> (rhs);
+  }
+
+  /************* Operators Overloading **************/
+
+  /**
+   * @param i An index, less than size ().
+   * @return the bit at index i.
+   */
+  bool operator[] (const size_t i) const noexcept (true)
+  {
+    assert (i < _size);
+    return (_words.data ()[i / BITS_PER_WORD] >> (i % BITS_PER_WORD)) & 1;
+  }
+
+  /**
+   * Keeps the bits that are 1 in both this and rhs.
+   * @param rhs Another vector of the same size.
+   * @return this.
+   */
+  template<const size_t M>
+  vl_bitvector &operator&= (const vl_bitvector<M> &rhs) noexcept (false)
+  {
+    apply<vl_bit_op::AND> (rhs);
+    return *this;
+  }
+
+  /**
+   * Sets the bits that are 1 in rhs.
+   * @param rhs Another vector of the same size.
+   * @return this.
+   */
+  template<const size_t M>
+  vl_bitvector &operator|= (const vl_bitvector<M> &rhs) noexcept (false)
+  {
+    apply<vl_bit_op::OR> (rhs);
+    return *this;
+  }
+
+  /**
+   * Flips the bits that are 1 in rhs.
+   * @param rhs Another vector of the same size.
+   * @return this.
+   */
+  template<const size_t M>
+  vl_bitvector &operator^= (const vl_bitvector<M> &rhs) noexcept (false)
+  {
+    apply<vl_bit_op::XOR> (rhs);
+    return *this;
+  }
+
+  /**
+   * Checks if both vectors have the same bits.
+   * @param rhs Another vector to compare with.
+   * @return true if this and rhs are equal, otherwise false.
+   */
+  bool operator== (const vl_bitvector &rhs) const noexcept (false)
+  {
+    return _size == rhs._size && _words == rhs._words;
+  }
+
+  /**
+   * Checks if both vectors have the same bits.
+   * @param rhs Another vector to compare with.
+   * @return true if this and rhs are not equal, otherwise false.
+   */
+  bool operator!= (const vl_bitvector &rhs) const noexcept (false)
+  {
+    return !(*this == rhs);
+  }
+
+};
+
+#endif //_VL_BITVECTOR_H_
@@ -0,0 +1,813 @@
+#ifndef _VL_DEQUE_H_
+#define _VL_DEQUE_H_
+
+#include "vl_vector.h"
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+/**
+ * How much slots a ring needs for N elements: the smallest power of 2 that
+ * is at least N, so positions wrap around with a mask instead of a modulo.
+ * @param N Number of elements.
+ * @return The number of slots.
+ */
+constexpr size_t vl_ring_slots (const size_t N) noexcept (true)
+{
+  size_t slots = 1;
+  while (slots < N)
+    {
+      slots *= 2;
+    }
+  return slots;
+}
+
+/**
+ * @param n Number of elements.
+ * @return The largest power of 2 that is at most n, and at least 1.
+ */
+constexpr size_t vl_ring_floor_slots (const size_t n) noexcept (true)
+{
+  size_t slots = 1;
+  while (slots * 2 <= n)
+    {
+      slots *= 2;
+    }
+  return slots;
+}
+
+/**
+ * How much slots of T fit on the stack of a vl_deque whose whole object
+ * takes at most Bytes, like vl_budget_capacity for a vl_vector: a power of
+ * 2 that fits next to the heap pointer, the capacity, the head and the size,
+ * and at least 1.
+ * @tparam T The type of the elements.
+ * @tparam Bytes The size budget of the whole vl_deque object.
+ */
+template<typename T, const size_t Bytes = DEFAULT_STATIC_BYTES>
+constexpr size_t vl_ring_budget_slots = vl_ring_floor_slots (
+    (Bytes >= sizeof (T *) + 3 * sizeof (size_t)) ?
+    (Bytes - sizeof (T *) - 3 * sizeof (size_t)) / sizeof (T) : 0);
+
+/**
+ * Represents a double ended queue in a ring buffer: the elements start at a
+ * head slot and wrap around the end of the buffer, so pushing and popping
+ * at both ends is O(1), unlike erasing the front of a vl_vector, which moves
+ * all the other elements. The ring is on the stack as long as the elements
+ * fit in it, otherwise on the heap, where it doubles when it's full.
+ * @tparam T The type of the elements.
+ * @tparam N How much elements can be on the stack, rounded up to a power
+ *           of 2. By default as much as fit in DEFAULT_STATIC_BYTES.
+ */
+template<typename T, const size_t N = vl_ring_budget_slots<T>>
+class vl_deque {
+ public:
+  // how much elements can be on the stack.
+  static constexpr size_t StaticCapacity = vl_ring_slots (N);
+
+ private:
+  /************* Private Fields **************/
+  T _stack_storage[StaticCapacity]; // holds the ring in the stack memory.
+  T *_heap_data; // holds the ring in the heap memory, or nullptr.
+  size_t _cap; // number of slots in the ring, a power of 2.
+  size_t _head; // the slot of the first element.
+  size_t _size; // number of elements.
+
+  /************* Private Methods **************/
+
+  /**
+   * @param i An index of an element.
+   * @return The slot of the element.
+   */
+  size_t slot (const size_t i) const noexcept (true)
+  {
+    return (_head + i) & (_cap - 1);
+  }
+
+  /**
+   * Resets a slot that an element left, so it doesn't hold on to the
+   * resources of the element. Trivially destructible elements have none.
+   * @param element The slot.
+   */
+  static void release (T &element) noexcept (false)
+  {
+    if constexpr (!std::is_trivially_destructible<T>::value)
+      {
+        element = T ();
+      }
+  }
+
+  /**
+   * Moves the elements to a heap ring of new_cap slots, starting at its
+   * first slot.
+   * @param new_cap The new number of slots, a power of 2 that is at least
+   *                size ().
+   */
+  void relocate (const size_t new_cap) noexcept (false)
+  {
+    T *heap = vl_allocate<T> (new_cap, alignof (T));
+    T *ring = data ();
+    try
+      {
+        for (size_t i = 0; i < _size; ++i)
+          {
+            heap[i] = std::move (ring[slot (i)]);
+          }
+      }
+    catch (...)
+      {
+        vl_deallocate (heap, new_cap, alignof (T));
+        throw;
+      }
+    if (_heap_data == nullptr)
+      {
+        for (size_t i = 0; i < _size; ++i)
+          {
+            release (ring[slot (i)]);
+          }
+      }
+    vl_deallocate (_heap_data, _cap, alignof (T));
+    _heap_data = heap;
+    _cap = new_cap;
+    _head = 0;
+  }
+
+  /**
+   * Makes room for one more element, doubling the ring if it's full, which
+   * moves the elements, so references to them don't refer to them anymore.
+   */
+  void grow () noexcept (false)
+  {
+    if (_size == _cap)
+      {
+        if (_cap > vl_max_size<T> () / 2)
+          {
+            throw std::length_error{"Capacity exceeds max_size"};
+          }
+        relocate (2 * _cap);
+      }
+  }
+
+  /**
+   * Takes the elements of rhs, which must be empty in this: its heap ring
+   * if it has one, otherwise moves them one by one. Leaves rhs empty.
+   * @param rhs Another deque.
+   */
+  void steal (vl_deque &&rhs) noexcept (true)
+  {
+    if (rhs._heap_data != nullptr)
+      {
+        _heap_data = rhs._heap_data;
+        _cap = rhs._cap;
+        _head = rhs._head;
+        _size = rhs._size;
+        rhs._heap_data = nullptr;
+        rhs._cap = StaticCapacity;
+        rhs._head = 0;
+        rhs._size = 0;
+        return;
+      }
+    for (size_t i = 0; i < rhs._size; ++i)
+      {
+        _stack_storage[i] = std::move (rhs._stack_storage[rhs.slot (i)]);
+      }
+    _size = rhs._size;
+    rhs._head = 0;
+    rhs._size = 0;
+  }
+
+ public:
+  /************* Iterator and Const Iterator **************/
+  using value_type = T;
+
+  /**
+   * A random access iterator over the elements, from the front to the back.
+   * @tparam W T for an iterator, or const T for a const iterator.
+   */
+  template<typename W>
+  class basic_iterator {
+   private:
+    W *_ring; // the ring of the deque.
+    size_t _mask; // the number of slots in the ring minus 1.
+    size_t _head; // the slot of the first element.
+    size_t _index; // the index of the current element.
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = W *;
+    using reference = W &;
+
+    /**
+     * Default constructor, of an iterator that points at nothing.
+     */
+    basic_iterator () : _ring (nullptr), _mask (0), _head (0), _index (0)
+    {}
+
+    /**
+     * Constructs an iterator to an element.
+     * @param ring The ring of a deque.
+     * @param cap The number of slots in the ring.
+     * @param head The slot of the first element.
+     * @param index The index of the element.
+     */
+    basic_iterator (W *ring, const size_t cap, const size_t head,
+                    const size_t index) :
+        _ring (ring), _mask (cap - 1), _head (head), _index (index)
+    {}
+
+    /**
+     * Converts an iterator to a const iterator.
+     * @param it An iterator.
+     */
+    template<typename U, typename = typename std::enable_if<
+        std::is_same<const U, W>::value>::type>
+    basic_iterator (const basic_iterator<U> &it) :
+        basic_iterator (it.ring (), it.mask () + 1, it.head (), it.index ())
+    {}
+
+    /**
+     * @return the ring of the deque.
+     */
+    W *ring () const noexcept (true)
+    {
+      return _ring;
+    }
+
+    /**
+     * @return the number of slots in the ring minus 1.
+     */
+    size_t mask () const noexcept (true)
+    {
+      return _mask;
+    }
+
+    /**
+     * @return the slot of the first element.
+     */
+    size_t head () const noexcept (true)
+    {
+      return _head;
+    }
+
+    /**
+     * @return the index of the current element.
+     */
+    size_t index () const noexcept (true)
+    {
+      return _index;
+    }
+
+    reference operator* () const noexcept (true)
+    {
+      return _ring[(_head + _index) & _mask];
+    }
+
+    pointer operator-> () const noexcept (true)
+    {
+      return &**this;
+    }
+
+    reference operator[] (const difference_type n) const noexcept (true)
+    {
+      return *(*this + n);
+    }
+
+    basic_iterator &operator++ () noexcept (true)
+    {
+      ++_index;
+      return *this;
+    }
+
+    basic_iterator operator++ (int) noexcept (true)
+    {
+      basic_iterator it = *this;
+      ++_index;
+      return it;
+    }
+
+    basic_iterator &operator-- () noexcept (true)
+    {
+      --_index;
+      return *this;
+    }
+
+    basic_iterator operator-- (int) noexcept (true)
+    {
+      basic_iterator it = *this;
+      --_index;
+      return it;
+    }
+
+    basic_iterator &operator+= (const difference_type n) noexcept (true)
+    {
+      _index += n;
+      return *this;
+    }
+
+    basic_iterator &operator-= (const difference_type n) noexcept (true)
+    {
+      _index -= n;
+      return *this;
+    }
+
+    basic_iterator operator+ (const difference_type n) const noexcept (true)
+    {
+      basic_iterator it = *this;
+      return it += n;
+    }
+
+    friend basic_iterator operator+ (const difference_type n,
+                                     const basic_iterator &it)
+    noexcept (true)
+    {
+      return it + n;
+    }
+
+    basic_iterator operator- (const difference_type n) const noexcept (true)
+    {
+      basic_iterator it = *this;
+      return it -= n;
+    }
+
+    difference_type operator- (const basic_iterator &rhs) const
+    noexcept (true)
+    {
+      return (difference_type) _index - (difference_type) rhs._index;
+    }
+
+    bool operator== (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _index == rhs._index;
+    }
+
+    bool operator!= (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _index != rhs._index;
+    }
+
+    bool operator< (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _index < rhs._index;
+    }
+
+    bool operator> (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _index > rhs._index;
+    }
+
+    bool operator<= (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _index <= rhs._index;
+    }
+
+    bool operator>= (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _index >= rhs._index;
+    }
+  };
+
+  using iterator = basic_iterator<T>;
+  using const_iterator = basic_iterator<const T>;
+
+  /************* Constructors & Destructor **************/
+
+  /**
+   * Default constructor which initializes an empty deque on the stack.
+   */
+  vl_deque () :
+      _heap_data (nullptr), _cap (StaticCapacity), _head (0), _size (0)
+  {}
+
+  /**
+   * Copy Constructor.
+   * @param rhs A deque to copy from.
+   */
+  vl_deque (const vl_deque &rhs) : vl_deque ()
+  {
+    *this = rhs;
+  }
+
+  /**
+   * Move Constructor. Steals the heap ring of rhs if it has one, and leaves
+   * rhs empty.
+   * @param rhs A deque to move from.
+   */
+  vl_deque (vl_deque &&rhs) noexcept (true) : vl_deque ()
+  {
+    steal (std::move (rhs));
+  }
+
+  /**
+   * Sequence based constructor. Pushes the elements of the range
+   * [first, last) to the back.
+   * @tparam ForwardIterator the type of iterator.
+   * @param first An iterator that represents the first element.
+   * @param last An iterator that represents the last element.
+   */
+  template<class ForwardIterator>
+  vl_deque (ForwardIterator first, ForwardIterator last) : vl_deque ()
+  {
+    for (; first != last; ++first)
+      {
+        push_back (*first);
+      }
+  }
+
+  /**
+   * Destructor.
+   */
+  ~vl_deque ()
+  {
+    vl_deallocate (_heap_data, _cap, alignof (T));
+  }
+
+  /**
+   * @return an iterator to the front.
+   */
+  iterator begin () noexcept (true)
+  {
+    return iterator (data (), _cap, _head, 0);
+  }
+
+  /**
+   * @return an iterator past the back.
+   */
+  iterator end () noexcept (true)
+  {
+    return iterator (data (), _cap, _head, _size);
+  }
+
+  /**
+   * @return a const iterator to the front.
+   */
+  const_iterator begin () const noexcept (true)
+  {
+    return const_iterator (data (), _cap, _head, 0);
+  }
+
+  /**
+   * @return a const iterator past the back.
+   */
+  const_iterator end () const noexcept (true)
+  {
+    return const_iterator (data (), _cap, _head, _size);
+  }
+
+  /************* Public Methods **************/
+
+  /**
+   * @return the number of elements in the deque.
+   */
+  size_t size () const noexcept (true)
+  {
+    return _size;
+  }
+
+  /**
+   * @return true if the deque is empty, otherwise false.
+   */
+  bool empty () const noexcept (true)
+  {
+    return _size == 0;
+  }
+
+  /**
+   * @return the number of slots in the ring.
+   */
+  size_t capacity () const noexcept (true)
+  {
+    return _cap;
+  }
+
+  /**
+   * @return a pointer to the ring, whose first element is at slot head ().
+   */
+  T *data () noexcept (true)
+  {
+    return (_heap_data != nullptr) ? _heap_data : _stack_storage;
+  }
+
+  /**
+   * @return a const pointer to the ring.
+   */
+  const T *data () const noexcept (true)
+  {
+    return (_heap_data != nullptr) ? _heap_data : _stack_storage;
+  }
+
+  /**
+   * @return the slot of the first element.
+   */
+  size_t head () const noexcept (true)
+  {
+    return _head;
+  }
+
+  /**
+   * Makes sure the deque can hold at least n elements without another
+   * allocation.
+   * @param n The requested capacity.
+   */
+  void reserve (const size_t n) noexcept (false)
+  {
+    if (n > _cap)
+      {
+        if (n > vl_max_size<T> () / 2)
+          {
+            throw std::length_error{"Capacity exceeds max_size"};
+          }
+        relocate (vl_ring_slots (n));
+      }
+  }
+
+  /**
+   * @param i An index.
+   * @return A reference to the element at index i.
+   */
+  T &at (const size_t i) noexcept (false)
+  {
+    if (i >= _size)
+      {
+        throw std::out_of_range{"Invalid index"};
+      }
+    return (*this)[i];
+  }
+
+  /**
+   * @param i An index.
+   * @return A const reference to the element at index i.
+   */
+  const T &at (const size_t i) const noexcept (false)
+  {
+    if (i >= _size)
+      {
+        throw std::out_of_range{"Invalid index"};
+      }
+    return (*this)[i];
+  }
+
+  /**
+   * @return A reference to the first element. The deque must not be empty.
+   */
+  T &front () noexcept (true)
+  {
+    return data ()[_head];
+  }
+
+  /**
+   * @return A const reference to the first element.
+   */
+  const T &front () const noexcept (true)
+  {
+    return data ()[_head];
+  }
+
+  /**
+   * @return A reference to the last element. The deque must not be empty.
+   */
+  T &back () noexcept (true)
+  {
+    return data ()[slot (_size - 1)];
+  }
+
+  /**
+   * @return A const reference to the last element.
+   */
+  const T &back () const noexcept (true)
+  {
+    return data ()[slot (_size - 1)];
+  }
+
+  /**
+   * Adds an element after the last one. v may be an element of the deque.
+   * @param v The element.
+   */
+  void push_back (const T &v) noexcept (false)
+  {
+    if (_size == _cap)
+      {
+        // growing moves v if it's an element of the deque, so copy it first.
+        push_back (T (v));
+        return;
+      }
+    data ()[slot (_size)] = v;
+    ++_size;
+  }
+
+  /**
+   * Adds an element after the last one. v may be an element of the deque.
+   * @param v The element, which is moved from.
+   */
+  void push_back (T &&v) noexcept (false)
+  {
+    if (_size == _cap)
+      {
+        T element (std::move (v));
+        grow ();
+        push_back (std::move (element));
+        return;
+      }
+    data ()[slot (_size)] = std::move (v);
+    ++_size;
+  }
+
+  /**
+   * Adds an element before the first one. v may be an element of the deque.
+   * @param v The element.
+   */
+  void push_front (const T &v) noexcept (false)
+  {
+    if (_size == _cap)
+      {
+        // growing moves v if it's an element of the deque, so copy it first.
+        push_front (T (v));
+        return;
+      }
+    const size_t head = (_head - 1) & (_cap - 1);
+    data ()[head] = v;
+    _head = head;
+    ++_size;
+  }
+
+  /**
+   * Adds an element before the first one. v may be an element of the deque.
+   * @param v The element, which is moved from.
+   */
+  void push_front (T &&v) noexcept (false)
+  {
+    if (_size == _cap)
+      {
+        T element (std::move (v));
+        grow ();
+        push_front (std::move (element));
+        return;
+      }
+    const size_t head = (_head - 1) & (_cap - 1);
+    data ()[head] = std::move (v);
+    _head = head;
+    ++_size;
+  }
+
+  /**
+   * Deletes the last element, if there is one.
+   */
+  void pop_back () noexcept (false)
+  {
+    if (_size == 0)
+      {
+        return;
+      }
+    release (back ());
+    --_size;
+  }
+
+  /**
+   * Deletes the first element, if there is one.
+   */
+  void pop_front () noexcept (false)
+  {
+    if (_size == 0)
+      {
+        return;
+      }
+    release (front ());
+    _head = slot (1);
+    --_size;
+  }
+
+  /**
+   * Deletes the first n elements, or all of them if there are less. Used
+   * with front_chunk to drain the deque in batches.
+   * @param n Number of elements to delete.
+   */
+  void pop_front (size_t n) noexcept (false)
+  {
+    n = std::min (n, _size);
+    for (size_t i = 0; i < n; ++i)
+      {
+        release (data ()[slot (i)]);
+      }
+    _head = slot (n);
+    _size -= n;
+  }
+
+  /**
+   * The elements from the front up to the back or up to the end of the
+   * ring, whichever comes first, are contiguous in memory; the rest of them
+   * start at the beginning of the ring. Processing this chunk and calling
+   * pop_front with its size walks the deque in at most two chunks per lap
+   * of the ring.
+   * @return A pointer to the first element, and the number of elements
+   *         that follow it contiguously.
+   */
+  std::pair<T *, size_t> front_chunk () noexcept (true)
+  {
+    return {data () + _head, std::min (_size, _cap - _head)};
+  }
+
+  /**
+   * @return A const pointer to the first element, and the number of
+   *         elements that follow it contiguously.
+   */
+  std::pair<const T *, size_t> front_chunk () const noexcept (true)
+  {
+    return {data () + _head, std::min (_size, _cap - _head)};
+  }
+
+  /**
+   * Deletes all the elements, and goes back to the stack.
+   */
+  void clear () noexcept (false)
+  {
+    if (_heap_data == nullptr)
+      {
+        pop_front (_size);
+      }
+    vl_deallocate (_heap_data, _cap, alignof (T));
+    _heap_data = nullptr;
+    _cap = StaticCapacity;
+    _head = 0;
+    _size = 0;
+  }
+
+  /************* Operators Overloading **************/
+
+  /**
+   * @param i An index.
+   * @return A reference to the element at index i.
+   */
+  T &operator[] (const size_t i) noexcept (true)
+  {
+    return data ()[slot (i)];
+  }
+
+  /**
+   * @param i An index.
+   * @return A const reference to the element at index i.
+   */
+  const T &operator[] (const size_t i) const noexcept (true)
+  {
+    return data ()[slot (i)];
+  }
+
+  /**
+   * Assignment operator - copies the elements of another deque.
+   * @param rhs Another deque to assign.
+   * @return this.
+   */
+  vl_deque &operator= (const vl_deque &rhs) noexcept (false)
+  {
+    if (this != &rhs)
+      {
+        clear ();
+        reserve (rhs._size);
+        for (size_t i = 0; i < rhs._size; ++i)
+          {
+            push_back (rhs[i]);
+          }
+      }
+    return *this;
+  }
+
+  /**
+   * Move assignment operator - steals the elements of another deque and
+   * leaves it empty.
+   * @param rhs Another deque to move from.
+   * @return this.
+   */
+  vl_deque &operator= (vl_deque &&rhs) noexcept (true)
+  {
+    if (this != &rhs)
+      {
+        clear ();
+        steal (std::move (rhs));
+      }
+    return *this;
+  }
+
+  /**
+   * Checks if both deques have the same elements in the same order.
+   * @param rhs Another deque to compare with.
+   * @return true if this and rhs are equal, otherwise false.
+   */
+  bool operator== (const vl_deque &rhs) const noexcept (false)
+  {
+    return _size == rhs._size && std::equal (begin (), end (), rhs.begin ());
+  }
+
+  /**
+   * Checks if both deques have the same elements in the same order.
+   * @param rhs Another deque to compare with.
+   * @return true if this and rhs are not equal, otherwise false.
+   */
+  bool operator!= (const vl_deque &rhs) const noexcept (false)
+  {
+    return !(*this == rhs);
+  }
+
+};
+
+#endif //_VL_DEQUE_H_
@@ -0,0 +1,632 @@
+#ifndef _VL_FLAT_MAP_H_
+#define _VL_FLAT_MAP_H_
+
+#include "vl_vector.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * Represents a map from unique keys to values, sorted by the keys. The keys
+ * and the values are kept in two separate vl_vectors at the same indices,
+ * so binary searches only touch the keys, and the first N entries are on
+ * the stack, which makes a small map a single block of memory without any
+ * allocation.
+ * @tparam K The type of the keys.
+ * @tparam V The type of the values.
+ * @tparam N How much entries can be on the stack. By default as much as
+ *           fit in both a default vl_vector of K and one of V, so each of
+ *           the two vectors stays within DEFAULT_STATIC_BYTES.
+ * @tparam Compare The strict weak order of the keys.
+ */
+template<typename K, typename V,
+    const size_t N = std::min (vl_budget_capacity<K>, vl_budget_capacity<V>),
+    typename Compare = std::less<K>>
+class vl_flat_map {
+ private:
+  /************* Private Fields **************/
+  vl_vector<K, N> _keys; // the keys, sorted by Compare without duplicates.
+  vl_vector<V, N> _values; // the value of every key, at the same index.
+  Compare _comp; // orders the keys.
+
+ public:
+  /************* Iterator and Const Iterator **************/
+  using key_type = K;
+  using mapped_type = V;
+
+  /**
+   * A random access iterator over the entries of the map, in the order of
+   * the keys. It points at a key and at its value, and dereferences to a
+   * pair of references to them.
+   * @tparam W V for an iterator, or const V for a const iterator.
+   */
+  template<typename W>
+  class basic_iterator {
+   private:
+    const K *_key; // the key of the current entry.
+    W *_value; // the value of the current entry.
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::pair<const K, V>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const K &, W &>;
+
+    /**
+     * Makes reference usable through operator->.
+     */
+    struct pointer {
+      reference ref; // the entry.
+
+      /**
+       * @return a pointer to the entry.
+       */
+      reference *operator-> () noexcept (true)
+      {
+        return &ref;
+      }
+    };
+
+    /**
+     * Constructs an iterator to the entry of the given key and value.
+     * @param key A pointer to a key in the map.
+     * @param value A pointer to the value of the key.
+     */
+    basic_iterator (const K *key, W *value) : _key (key), _value (value)
+    {}
+
+    /**
+     * Converts an iterator to a const iterator.
+     * @param it An iterator.
+     */
+    template<typename U, typename = typename std::enable_if<
+        std::is_same<const U, W>::value>::type>
+    basic_iterator (const basic_iterator<U> &it) :
+        _key (&it.key ()), _value (&it.value ())
+    {}
+
+    /**
+     * @return the key of the current entry.
+     */
+    const K &key () const noexcept (true)
+    {
+      return *_key;
+    }
+
+    /**
+     * @return the value of the current entry.
+     */
+    W &value () const noexcept (true)
+    {
+      return *_value;
+    }
+
+    reference operator* () const noexcept (true)
+    {
+      return reference (*_key, *_value);
+    }
+
+    pointer operator-> () const noexcept (true)
+    {
+      return pointer{**this};
+    }
+
+    reference operator[] (const difference_type n) const noexcept (true)
+    {
+      return *(*this + n);
+    }
+
+    basic_iterator &operator++ () noexcept (true)
+    {
+      ++_key;
+      ++_value;
+      return *this;
+    }
+
+    basic_iterator operator++ (int) noexcept (true)
+    {
+      basic_iterator it = *this;
+      ++*this;
+      return it;
+    }
+
+    basic_iterator &operator-- () noexcept (true)
+    {
+      --_key;
+      --_value;
+      return *this;
+    }
+
+    basic_iterator operator-- (int) noexcept (true)
+    {
+      basic_iterator it = *this;
+      --*this;
+      return it;
+    }
+
+    basic_iterator &operator+= (const difference_type n) noexcept (true)
+    {
+      _key += n;
+      _value += n;
+      return *this;
+    }
+
+    basic_iterator &operator-= (const difference_type n) noexcept (true)
+    {
+      return *this += -n;
+    }
+
+    basic_iterator operator+ (const difference_type n) const noexcept (true)
+    {
+      basic_iterator it = *this;
+      return it += n;
+    }
+
+    basic_iterator operator- (const difference_type n) const noexcept (true)
+    {
+      basic_iterator it = *this;
+      return it -= n;
+    }
+
+    difference_type operator- (const basic_iterator &rhs) const
+    noexcept (true)
+    {
+      return _key - rhs._key;
+    }
+
+    bool operator== (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _key == rhs._key;
+    }
+
+    bool operator!= (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _key != rhs._key;
+    }
+
+    bool operator< (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _key < rhs._key;
+    }
+  };
+
+  using iterator = basic_iterator<V>;
+  using const_iterator = basic_iterator<const V>;
+
+ private:
+  /************* Private Methods **************/
+
+  /**
+   * @param i An index of an entry.
+   * @return an iterator to the entry at index i.
+   */
+  iterator at_index (const size_t i) noexcept (true)
+  {
+    return iterator (_keys.data () + i, _values.data () + i);
+  }
+
+  /**
+   * @param i An index of an entry.
+   * @return a const iterator to the entry at index i.
+   */
+  const_iterator at_index (const size_t i) const noexcept (true)
+  {
+    return const_iterator (_keys.data () + i, _values.data () + i);
+  }
+
+  /**
+   * @param key A key.
+   * @return the index of the first key that doesn't come before key.
+   */
+  size_t lower_index (const K &key) const noexcept (false)
+  {
+    return std::lower_bound (_keys.begin (), _keys.end (), key, _comp)
+           - _keys.begin ();
+  }
+
+  /**
+   * @param key A key.
+   * @return the index of the key, or size () if it isn't in the map.
+   */
+  size_t find_index (const K &key) const noexcept (false)
+  {
+    const size_t i = lower_index (key);
+    return (i != size () && !_comp (key, _keys.data ()[i])) ? i : size ();
+  }
+
+  /**
+   * Inserts an entry before index i.
+   * @param i An index of an entry.
+   * @param key The key of the new entry.
+   * @param value The value of the new entry.
+   * @return an iterator to the new entry.
+   */
+  iterator insert_at (const size_t i, const K &key, const V &value)
+  noexcept (false)
+  {
+    _keys.insert (_keys.begin () + i, key);
+    _values.insert (_values.begin () + i, value);
+    return at_index (i);
+  }
+
+ public:
+  /************* Constructors **************/
+
+  /**
+   * Default constructor which initializes an empty map.
+   */
+  vl_flat_map () = default;
+
+  /**
+   * Sequence based constructor. Inserts the (key, value) pairs of the
+   * range [first, last), which don't have to be sorted or unique.
+   * @tparam ForwardIterator the type of iterator.
+   * @param first An iterator that represents the first pair.
+   * @param last An iterator that represents the last pair.
+   */
+  template<class ForwardIterator>
+  vl_flat_map (ForwardIterator first, ForwardIterator last)
+  {
+    insert (first, last);
+  }
+
+  /**
+   * @return an iterator to the entry with the smallest key.
+   */
+  iterator begin () noexcept (true)
+  {
+    return at_index (0);
+  }
+
+  /**
+   * @return an iterator past the entry with the largest key.
+   */
+  iterator end () noexcept (true)
+  {
+    return at_index (size ());
+  }
+
+  /**
+   * @return a const iterator to the entry with the smallest key.
+   */
+  const_iterator begin () const noexcept (true)
+  {
+    return at_index (0);
+  }
+
+  /**
+   * @return a const iterator past the entry with the largest key.
+   */
+  const_iterator end () const noexcept (true)
+  {
+    return at_index (size ());
+  }
+
+  /************* Public Methods **************/
+
+  /**
+   * @return the keys, in ascending order.
+   */
+  const vl_vector<K, N> &keys () const noexcept (true)
+  {
+    return _keys;
+  }
+
+  /**
+   * @return the values, in the order of their keys.
+   */
+  const vl_vector<V, N> &values () const noexcept (true)
+  {
+    return _values;
+  }
+
+  /**
+   * @return the number of entries in the map.
+   */
+  size_t size () const noexcept (true)
+  {
+    return _keys.size ();
+  }
+
+  /**
+   * @return the capacity of the map.
+   */
+  size_t capacity () const noexcept (true)
+  {
+    return _keys.capacity ();
+  }
+
+  /**
+   * @return true if the map is empty, otherwise false.
+   */
+  bool empty () const noexcept (true)
+  {
+    return _keys.empty ();
+  }
+
+  /**
+   * Makes sure the map can hold at least n entries without another
+   * allocation.
+   * @param n The requested capacity.
+   */
+  void reserve (const size_t n) noexcept (false)
+  {
+    _keys.reserve (n);
+    _values.reserve (n);
+  }
+
+  /**
+   * Deletes all the entries from the map.
+   */
+  void clear () noexcept (false)
+  {
+    _keys.clear ();
+    _values.clear ();
+  }
+
+  /**
+   * @param key A key.
+   * @return an iterator to the first entry whose key doesn't come before
+   *         key.
+   */
+  iterator lower_bound (const K &key) noexcept (false)
+  {
+    return at_index (lower_index (key));
+  }
+
+  /**
+   * @param key A key.
+   * @return a const iterator to the first entry whose key doesn't come
+   *         before key.
+   */
+  const_iterator lower_bound (const K &key) const noexcept (false)
+  {
+    return at_index (lower_index (key));
+  }
+
+  /**
+   * @param key A key.
+   * @return an iterator to the entry of the key, or end () if it isn't in
+   *         the map.
+   */
+  iterator find (const K &key) noexcept (false)
+  {
+    return at_index (find_index (key));
+  }
+
+  /**
+   * @param key A key.
+   * @return a const iterator to the entry of the key, or end () if it
+   *         isn't in the map.
+   */
+  const_iterator find (const K &key) const noexcept (false)
+  {
+    return at_index (find_index (key));
+  }
+
+  /**
+   * @param key A key.
+   * @return true if the map contains the key, otherwise false.
+   */
+  bool contains (const K &key) const noexcept (false)
+  {
+    return find_index (key) != size ();
+  }
+
+  /**
+   * @param key A key.
+   * @return 1 if the map contains the key, otherwise 0.
+   */
+  size_t count (const K &key) const noexcept (false)
+  {
+    return contains (key) ? 1 : 0;
+  }
+
+  /**
+   * @param key A key.
+   * @return A reference to the value of the key.
+   */
+  V &at (const K &key) noexcept (false)
+  {
+    const size_t i = find_index (key);
+    if (i == size ())
+      {
+        throw std::out_of_range{"Invalid key"};
+      }
+    return _values[i];
+  }
+
+  /**
+   * @param key A key.
+   * @return A const reference to the value of the key.
+   */
+  const V &at (const K &key) const noexcept (false)
+  {
+    const size_t i = find_index (key);
+    if (i == size ())
+      {
+        throw std::out_of_range{"Invalid key"};
+      }
+    return _values.data ()[i];
+  }
+
+  /**
+   * Inserts an entry, unless the map already contains the key.
+   * @param key The key of the entry.
+   * @param value The value of the entry.
+   * @return An iterator to the entry of the key, and true if it was
+   *         inserted.
+   */
+  std::pair<iterator, bool> insert (const K &key, const V &value)
+  noexcept (false)
+  {
+    const size_t i = lower_index (key);
+    if (i != size () && !_comp (key, _keys[i]))
+      {
+        return {at_index (i), false};
+      }
+    return {insert_at (i, key, value), true};
+  }
+
+  /**
+   * Inserts an entry, or assigns the value to the key if the map already
+   * contains it.
+   * @param key The key of the entry.
+   * @param value The value of the entry.
+   * @return An iterator to the entry of the key, and true if it was
+   *         inserted.
+   */
+  std::pair<iterator, bool> insert_or_assign (const K &key, const V &value)
+  noexcept (false)
+  {
+    const size_t i = lower_index (key);
+    if (i != size () && !_comp (key, _keys[i]))
+      {
+        _values[i] = value;
+        return {at_index (i), false};
+      }
+    return {insert_at (i, key, value), true};
+  }
+
+  /**
+   * Inserts the (key, value) pairs of the range [first, last) with a single
+   * merge: they are sorted by key on their own, then merged with the
+   * entries of the map from the back, so the map grows at most once and
+   * every entry moves at most once. Of entries with equivalent keys, the
+   * one that was in the map first, or else the first in the range, is
+   * kept.
+   * @tparam ForwardIterator the type of iterator.
+   * @param first An iterator that represents the first pair.
+   * @param last An iterator that represents the last pair.
+   */
+  template<class ForwardIterator>
+  void insert (ForwardIterator first, ForwardIterator last) noexcept (false)
+  {
+    vl_vector<std::pair<K, V>, N> added (first, last);
+    if (added.empty ())
+      {
+        return;
+      }
+    std::stable_sort (added.begin (), added.end (),
+                      [this] (const std::pair<K, V> &a,
+                              const std::pair<K, V> &b) {
+                        return _comp (a.first, b.first);
+                      });
+    const size_t n = size ();
+    reserve (n + added.size ());
+    for (const std::pair<K, V> &entry : added)
+      {
+        _keys.push_back (entry.first);
+        _values.push_back (entry.second);
+      }
+    K *keys = _keys.data ();
+    V *values = _values.data ();
+    size_t i = n; // entries of the map that weren't merged yet.
+    size_t j = added.size (); // added entries that weren't merged yet.
+    size_t w = size (); // where the next merged entry goes.
+    while (j > 0)
+      {
+        --w;
+        if (i > 0 && _comp (added[j - 1].first, keys[i - 1]))
+          {
+            --i;
+            keys[w] = std::move (keys[i]);
+            values[w] = std::move (values[i]);
+          }
+        else
+          {
+            --j;
+            keys[w] = std::move (added[j].first);
+            values[w] = std::move (added[j].second);
+          }
+      }
+    // keeps the first entry of every run of equivalent keys.
+    size_t last_unique = 0;
+    for (size_t k = 1; k < size (); ++k)
+      {
+        if (_comp (keys[last_unique], keys[k]))
+          {
+            ++last_unique;
+            if (last_unique != k)
+              {
+                keys[last_unique] = std::move (keys[k]);
+                values[last_unique] = std::move (values[k]);
+              }
+          }
+      }
+    _keys.erase (_keys.begin () + last_unique + 1, _keys.end ());
+    _values.erase (_values.begin () + last_unique + 1, _values.end ());
+  }
+
+  /**
+   * Deletes the entry that 'it' points at from the map.
+   * @param it An iterator to an entry in the map.
+   * @return An iterator to the entry after the deleted entry.
+   */
+  iterator erase (const_iterator it) noexcept (false)
+  {
+    const size_t i = &it.key () - _keys.data ();
+    _keys.erase (_keys.begin () + i);
+    _values.erase (_values.begin () + i);
+    return at_index (i);
+  }
+
+  /**
+   * Deletes the entry of the key from the map, if it's there.
+   * @param key A key to delete.
+   * @return 1 if the entry was deleted, otherwise 0.
+   */
+  size_t erase (const K &key) noexcept (false)
+  {
+    const size_t i = find_index (key);
+    if (i == size ())
+      {
+        return 0;
+      }
+    _keys.erase (_keys.begin () + i);
+    _values.erase (_values.begin () + i);
+    return 1;
+  }
+
+  /************* Operators Overloading **************/
+
+  /**
+   * @param key A key.
+   * @return A reference to the value of the key, which is value
+   *         initialized and inserted if the map doesn't contain the key.
+   */
+  V &operator[] (const K &key) noexcept (false)
+  {
+    const size_t i = lower_index (key);
+    if (i == size () || _comp (key, _keys[i]))
+      {
+        insert_at (i, key, V ());
+      }
+    return _values[i];
+  }
+
+  /**
+   * Checks if both maps contain the same entries.
+   * @param rhs Another map to compare with.
+   * @return true if this and rhs are equal, otherwise false.
+   */
+  bool operator== (const vl_flat_map &rhs) const noexcept (false)
+  {
+    return _keys == rhs._keys && _values == rhs._values;
+  }
+
+  /**
+   * Checks if both maps contain the same entries.
+   * @param rhs Another map to compare with.
+   * @return true if this and rhs are not equal, otherwise false.
+   */
+  bool operator!= (const vl_flat_map &rhs) const noexcept (false)
+  {
+    return !(*this == rhs);
+  }
+
+};
+
+#endif //_VL_FLAT_MAP_H_
@@ -0,0 +1,306 @@
+#ifndef _VL_FLAT_SET_H_
+#define _VL_FLAT_SET_H_
+
+#include "vl_vector.h"
+#include <functional>
+#include <utility>
+
+/**
+ * Represents a sorted set of unique keys, stored contiguously in a
+ * vl_vector. The first N keys are on the stack, so a small set is a single
+ * block of memory without any allocation, and lookups are binary searches
+ * over it instead of walks between the nodes of a tree.
+ * @tparam K The type of the keys.
+ * @tparam N How much keys can be on the stack. By default as much as fit
+ *           in a default vl_vector of K.
+ * @tparam Compare The strict weak order of the keys.
+ */
+template<typename K, const size_t N = vl_budget_capacity<K>,
+    typename Compare = std::less<K>>
+class vl_flat_set {
+ private:
+  /************* Private Fields **************/
+  vl_vector<K, N> _keys; // the keys, sorted by Compare without duplicates.
+  Compare _comp; // orders the keys.
+
+  /************* Private Methods **************/
+
+  /**
+   * @param a A key.
+   * @param b Another key.
+   * @return true if neither of the keys comes before the other.
+   */
+  bool equivalent (const K &a, const K &b) const noexcept (false)
+  {
+    return !_comp (a, b) && !_comp (b, a);
+  }
+
+ public:
+  /************* Constructors **************/
+
+  /**
+   * Default constructor which initializes an empty set.
+   */
+  vl_flat_set () = default;
+
+  /**
+   * Sequence based constructor. Inserts the keys of the range
+   * [first, last), which don't have to be sorted or unique.
+   * @tparam ForwardIterator the type of iterator.
+   * @param first An iterator that represents the first key.
+   * @param last An iterator that represents the last key.
+   */
+  template<class ForwardIterator>
+  vl_flat_set (ForwardIterator first, ForwardIterator last)
+  {
+    insert (first, last);
+  }
+
+  /************* Iterator, Reverse Iterator and their Const **************/
+  using key_type = K;
+  using value_type = K;
+  using iterator = const K *; // keys can't be changed in place.
+  using const_iterator = const K *;
+  using reverse_iterator = std::reverse_iterator<const_iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  /**
+   * @return an iterator to the smallest key.
+   */
+  const_iterator begin () const noexcept (true)
+  {
+    return _keys.begin ();
+  }
+
+  /**
+   * @return an iterator past the largest key.
+   */
+  const_iterator end () const noexcept (true)
+  {
+    return _keys.end ();
+  }
+
+  /**
+   * @return a reverse iterator to the largest key.
+   */
+  const_reverse_iterator rbegin () const noexcept (true)
+  {
+    return const_reverse_iterator (end ());
+  }
+
+  /**
+   * @return a reverse iterator before the smallest key.
+   */
+  const_reverse_iterator rend () const noexcept (true)
+  {
+    return const_reverse_iterator (begin ());
+  }
+
+  /************* Public Methods **************/
+
+  /**
+   * @return a pointer to the keys, in ascending order.
+   */
+  const K *data () const noexcept (true)
+  {
+    return _keys.data ();
+  }
+
+  /**
+   * @return the number of keys in the set.
+   */
+  size_t size () const noexcept (true)
+  {
+    return _keys.size ();
+  }
+
+  /**
+   * @return the capacity of the set.
+   */
+  size_t capacity () const noexcept (true)
+  {
+    return _keys.capacity ();
+  }
+
+  /**
+   * @return true if the set is empty, otherwise false.
+   */
+  bool empty () const noexcept (true)
+  {
+    return _keys.empty ();
+  }
+
+  /**
+   * Makes sure the set can hold at least n keys without another
+   * allocation.
+   * @param n The requested capacity.
+   */
+  void reserve (const size_t n) noexcept (false)
+  {
+    _keys.reserve (n);
+  }
+
+  /**
+   * Deletes all the keys from the set.
+   */
+  void clear () noexcept (false)
+  {
+    _keys.clear ();
+  }
+
+  /**
+   * @param key A key.
+   * @return an iterator to the first key that doesn't come before key.
+   */
+  const_iterator lower_bound (const K &key) const noexcept (false)
+  {
+    return std::lower_bound (begin (), end (), key, _comp);
+  }
+
+  /**
+   * @param key A key.
+   * @return an iterator to the first key that comes after key.
+   */
+  const_iterator upper_bound (const K &key) const noexcept (false)
+  {
+    return std::upper_bound (begin (), end (), key, _comp);
+  }
+
+  /**
+   * @param key A key.
+   * @return an iterator to the key, or end () if it isn't in the set.
+   */
+  const_iterator find (const K &key) const noexcept (false)
+  {
+    const_iterator it = lower_bound (key);
+    return (it != end () && !_comp (key, *it)) ? it : end ();
+  }
+
+  /**
+   * @param key A key.
+   * @return true if the set contains the key, otherwise false.
+   */
+  bool contains (const K &key) const noexcept (false)
+  {
+    return find (key) != end ();
+  }
+
+  /**
+   * @param key A key.
+   * @return 1 if the set contains the key, otherwise 0.
+   */
+  size_t count (const K &key) const noexcept (false)
+  {
+    return contains (key) ? 1 : 0;
+  }
+
+  /**
+   * Inserts a key in its place, unless the set already contains it.
+   * @param key A key to insert.
+   * @return An iterator to the key in the set, and true if it was
+   *         inserted.
+   */
+  std::pair<const_iterator, bool> insert (const K &key) noexcept (false)
+  {
+    const_iterator it = lower_bound (key);
+    if (it != end () && !_comp (key, *it))
+      {
+        return {it, false};
+      }
+    return {_keys.insert (it, key), true};
+  }
+
+  /**
+   * Inserts the keys of the range [first, last) with a single merge: they
+   * are sorted on their own, then merged with the keys of the set from the
+   * back, so the set grows at most once and every key moves at most once.
+   * Of equivalent keys, the one that was in the set first, or else the
+   * first in the range, is kept.
+   * @tparam ForwardIterator the type of iterator.
+   * @param first An iterator that represents the first key.
+   * @param last An iterator that represents the last key.
+   */
+  template<class ForwardIterator>
+  void insert (ForwardIterator first, ForwardIterator last) noexcept (false)
+  {
+    vl_vector<K, N> added (first, last);
+    if (added.empty ())
+      {
+        return;
+      }
+    std::stable_sort (added.begin (), added.end (), _comp);
+    const size_t n = _keys.size ();
+    _keys.insert (_keys.end (), added.begin (), added.end ());
+    K *keys = _keys.data ();
+    size_t i = n; // keys of the set that weren't merged yet.
+    size_t j = added.size (); // added keys that weren't merged yet.
+    size_t w = _keys.size (); // where the next merged key goes.
+    while (j > 0)
+      {
+        if (i > 0 && _comp (added[j - 1], keys[i - 1]))
+          {
+            keys[--w] = std::move (keys[--i]);
+          }
+        else
+          {
+            keys[--w] = std::move (added[--j]);
+          }
+      }
+    K *last_unique = std::unique (keys, keys + _keys.size (),
+                                  [this] (const K &a, const K &b) {
+                                    return equivalent (a, b);
+                                  });
+    _keys.erase (last_unique, _keys.end ());
+  }
+
+  /**
+   * Deletes the key that 'it' points at from the set.
+   * @param it An iterator to a key in the set.
+   * @return An iterator to the key after the deleted key.
+   */
+  const_iterator erase (const_iterator it) noexcept (false)
+  {
+    return _keys.erase (it);
+  }
+
+  /**
+   * Deletes the key from the set, if it's there.
+   * @param key A key to delete.
+   * @return 1 if the key was deleted, otherwise 0.
+   */
+  size_t erase (const K &key) noexcept (false)
+  {
+    const_iterator it = find (key);
+    if (it == end ())
+      {
+        return 0;
+      }
+    _keys.erase (it);
+    return 1;
+  }
+
+  /************* Operators Overloading **************/
+
+  /**
+   * Checks if both sets contain the same keys.
+   * @param rhs Another set to compare with.
+   * @return true if this and rhs are equal, otherwise false.
+   */
+  bool operator== (const vl_flat_set &rhs) const noexcept (false)
+  {
+    return _keys == rhs._keys;
+  }
+
+  /**
+   * Checks if both sets contain the same keys.
+   * @param rhs Another set to compare with.
+   * @return true if this and rhs are not equal, otherwise false.
+   */
+  bool operator!= (const vl_flat_set &rhs) const noexcept (false)
+  {
+    return _keys != rhs._keys;
+  }
+
+};
+
+#endif //_VL_FLAT_SET_H_
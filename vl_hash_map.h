@@ -0,0 +1,442 @@
+#ifndef _VL_HASH_MAP_H_
+#define _VL_HASH_MAP_H_
+
+#include "vl_hash_table.h"
+#include <iterator>
+#include <stdexcept>
+
+/**
+ * Represents a map from unique keys to values in an open addressing hash
+ * table (see vl_hash_table). The values are kept in a vl_vector of their
+ * own, at the slots of their keys, so probing only touches the control
+ * bytes and the keys. Up to N entries fit in the slots on the stack, so
+ * small maps never allocate; beyond that the slots move to the heap, like a
+ * vl_vector that spills.
+ * Like the keys, the values are constructed in every slot, used or not: V
+ * must be default constructible and move assignable, a free slot holds a
+ * V (), and erasing an entry assigns V () to its value, which releases
+ * whatever the value held. So a map of N slots keeps N live values.
+ * @tparam K The type of the keys.
+ * @tparam V The type of the values.
+ * @tparam N How much entries fit on the stack.
+ *           Unlike vl_vector, the default is a count and not a byte
+ *           budget: the slots come in whole groups of HASH_GROUP, so even
+ *           the smallest table takes more than DEFAULT_STATIC_BYTES.
+ * @tparam Hash Hashes the keys.
+ * @tparam KeyEqual Compares the keys.
+ */
+template<typename K, typename V, const size_t N = DEFAULT_STATIC_CAPACITY,
+    typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class vl_hash_map : public vl_hash_table<K, vl_hash_slots (N), Hash,
+                                         KeyEqual> {
+  static_assert (std::is_default_constructible<V>::value,
+                 "V must be default constructible, every slot holds one");
+
+  static constexpr size_t Slots = vl_hash_slots (N);
+
+ private:
+  /************* Private Fields **************/
+  vl_vector<V, Slots> _values; // the value of the key in a slot.
+
+ protected:
+  /************* Protected Methods **************/
+
+  /**
+   * Moves the keys and the values to a new table of new_cap slots.
+   * @param new_cap The number of slots of the new table.
+   */
+  void rehash (const size_t new_cap) noexcept (false) override
+  {
+    vl_vector<V, Slots> values;
+    values.reserve (new_cap);
+    values.resize (new_cap);
+    V *old_values = _values.data ();
+    this->rehash_keys (new_cap, [&values, old_values] (size_t from,
+                                                       size_t to) {
+      values.data ()[to] = std::move (old_values[from]);
+    });
+    _values = std::move (values);
+  }
+
+ public:
+  /************* Iterator and Const Iterator **************/
+  using key_type = K;
+  using mapped_type = V;
+
+  /**
+   * A forward iterator over the entries of the map, in the order of their
+   * slots. It dereferences to a pair of references to the key and the
+   * value.
+   * @tparam W V for an iterator, or const V for a const iterator.
+   */
+  template<typename W>
+  class basic_iterator {
+   private:
+    const vl_hash_map *_map; // the map.
+    W *_values; // the values of the map.
+    size_t _slot; // the slot of the current entry, or capacity () at end.
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::pair<const K, V>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<const K &, W &>;
+
+    /**
+     * Makes reference usable through operator->.
+     */
+    struct pointer {
+      reference ref; // the entry.
+
+      /**
+       * @return a pointer to the entry.
+       */
+      reference *operator-> () noexcept (true)
+      {
+        return &ref;
+      }
+    };
+
+    /**
+     * Constructs an iterator to the entry in a slot.
+     * @param map A map.
+     * @param values The values of the map.
+     * @param slot A used slot of the map, or its capacity ().
+     */
+    basic_iterator (const vl_hash_map *map, W *values, const size_t slot) :
+        _map (map), _values (values), _slot (slot)
+    {}
+
+    /**
+     * Converts an iterator to a const iterator.
+     * @param it An iterator.
+     */
+    template<typename U, typename = typename std::enable_if<
+        std::is_same<const U, W>::value>::type>
+    basic_iterator (const basic_iterator<U> &it) :
+        _map (it.map ()), _values (it.values ()), _slot (it.slot ())
+    {}
+
+    /**
+     * @return the map.
+     */
+    const vl_hash_map *map () const noexcept (true)
+    {
+      return _map;
+    }
+
+    /**
+     * @return the values of the map.
+     */
+    W *values () const noexcept (true)
+    {
+      return _values;
+    }
+
+    /**
+     * @return the slot of the current entry.
+     */
+    size_t slot () const noexcept (true)
+    {
+      return _slot;
+    }
+
+    reference operator* () const noexcept (true)
+    {
+      return reference (_map->_keys.data ()[_slot], _values[_slot]);
+    }
+
+    pointer operator-> () const noexcept (true)
+    {
+      return pointer{**this};
+    }
+
+    basic_iterator &operator++ () noexcept (true)
+    {
+      _slot = _map->next_used (_slot + 1);
+      return *this;
+    }
+
+    basic_iterator operator++ (int) noexcept (true)
+    {
+      basic_iterator it = *this;
+      ++*this;
+      return it;
+    }
+
+    bool operator== (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _slot == rhs._slot;
+    }
+
+    bool operator!= (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _slot != rhs._slot;
+    }
+  };
+
+  using iterator = basic_iterator<V>;
+  using const_iterator = basic_iterator<const V>;
+
+  /************* Constructors **************/
+
+  /**
+   * Default constructor which initializes an empty map.
+   */
+  vl_hash_map ()
+  {
+    _values.resize (Slots);
+  }
+
+  /**
+   * Sequence based constructor. Inserts the (key, value) pairs of the
+   * range [first, last).
+   * @tparam ForwardIterator the type of iterator.
+   * @param first An iterator that represents the first pair.
+   * @param last An iterator that represents the last pair.
+   */
+  template<class ForwardIterator>
+  vl_hash_map (ForwardIterator first, ForwardIterator last) : vl_hash_map ()
+  {
+    for (; first != last; ++first)
+      {
+        insert (first->first, first->second);
+      }
+  }
+
+  /**
+   * @return an iterator to the first entry.
+   */
+  iterator begin () noexcept (true)
+  {
+    return iterator (this, _values.data (), this->next_used (0));
+  }
+
+  /**
+   * @return an iterator past the last entry.
+   */
+  iterator end () noexcept (true)
+  {
+    return iterator (this, _values.data (), this->capacity ());
+  }
+
+  /**
+   * @return a const iterator to the first entry.
+   */
+  const_iterator begin () const noexcept (true)
+  {
+    return const_iterator (this, _values.data (), this->next_used (0));
+  }
+
+  /**
+   * @return a const iterator past the last entry.
+   */
+  const_iterator end () const noexcept (true)
+  {
+    return const_iterator (this, _values.data (), this->capacity ());
+  }
+
+  /************* Public Methods **************/
+
+  /**
+   * @param key A key.
+   * @return an iterator to the entry of the key, or end () if it isn't in
+   *         the map.
+   */
+  iterator find (const K &key) noexcept (false)
+  {
+    const size_t slot = this->find_slot (key, this->hash_of (key));
+    return iterator (this, _values.data (), slot);
+  }
+
+  /**
+   * @param key A key.
+   * @return a const iterator to the entry of the key, or end () if it
+   *         isn't in the map.
+   */
+  const_iterator find (const K &key) const noexcept (false)
+  {
+    const size_t slot = this->find_slot (key, this->hash_of (key));
+    return const_iterator (this, _values.data (), slot);
+  }
+
+  /**
+   * @param key A key.
+   * @return A reference to the value of the key.
+   */
+  V &at (const K &key) noexcept (false)
+  {
+    const size_t slot = this->find_slot (key, this->hash_of (key));
+    if (slot == this->capacity ())
+      {
+        throw std::out_of_range{"Invalid key"};
+      }
+    return _values.data ()[slot];
+  }
+
+  /**
+   * @param key A key.
+   * @return A const reference to the value of the key.
+   */
+  const V &at (const K &key) const noexcept (false)
+  {
+    const size_t slot = this->find_slot (key, this->hash_of (key));
+    if (slot == this->capacity ())
+      {
+        throw std::out_of_range{"Invalid key"};
+      }
+    return _values.data ()[slot];
+  }
+
+  /**
+   * Inserts an entry, unless the map already contains the key.
+   * @param key The key of the entry.
+   * @param value The value of the entry.
+   * @return An iterator to the entry of the key, and true if it was
+   *         inserted.
+   */
+  std::pair<iterator, bool> insert (const K &key, const V &value)
+  noexcept (false)
+  {
+    return put<false> (key, value);
+  }
+
+  /**
+   * Inserts an entry, or assigns the value to the key if the map already
+   * contains it.
+   * @param key The key of the entry.
+   * @param value The value of the entry.
+   * @return An iterator to the entry of the key, and true if it was
+   *         inserted.
+   */
+  std::pair<iterator, bool> insert_or_assign (const K &key, const V &value)
+  noexcept (false)
+  {
+    return put<true> (key, value);
+  }
+
+  /**
+   * Deletes the entry that 'it' points at from the map.
+   * @param it An iterator to an entry in the map.
+   * @return An iterator to the entry after the deleted entry.
+   */
+  iterator erase (const_iterator it) noexcept (false)
+  {
+    _values.data ()[it.slot ()] = V ();
+    this->erase_slot (it.slot ());
+    return iterator (this, _values.data (),
+                     this->next_used (it.slot () + 1));
+  }
+
+  /**
+   * Deletes the entry of the key from the map, if it's there.
+   * @param key A key to delete.
+   * @return 1 if the entry was deleted, otherwise 0.
+   */
+  size_t erase (const K &key) noexcept (false)
+  {
+    const size_t slot = this->find_slot (key, this->hash_of (key));
+    if (slot == this->capacity ())
+      {
+        return 0;
+      }
+    _values.data ()[slot] = V ();
+    this->erase_slot (slot);
+    return 1;
+  }
+
+  /**
+   * Deletes all the entries, and goes back to the stack.
+   */
+  void clear () noexcept (false) override
+  {
+    vl_hash_table<K, Slots, Hash, KeyEqual>::clear ();
+    _values.clear ();
+    _values.resize (Slots);
+  }
+
+  /************* Operators Overloading **************/
+
+  /**
+   * @param key A key.
+   * @return A reference to the value of the key, which is value
+   *         initialized and inserted if the map doesn't contain the key.
+   */
+  V &operator[] (const K &key) noexcept (false)
+  {
+    // a new slot already holds a value initialized V.
+    const size_t slot = this->insert_slot (key).first;
+    return _values.data ()[slot];
+  }
+
+  /**
+   * Checks if both maps contain the same entries, in any order.
+   * @param rhs Another map to compare with.
+   * @return true if this and rhs are equal, otherwise false.
+   */
+  bool operator== (const vl_hash_map &rhs) const noexcept (false)
+  {
+    if (this->size () != rhs.size ())
+      {
+        return false;
+      }
+    for (const auto entry : *this)
+      {
+        const_iterator it = rhs.find (entry.first);
+        if (it == rhs.end () || !((*it).second == entry.second))
+          {
+            return false;
+          }
+      }
+    return true;
+  }
+
+  /**
+   * Checks if both maps contain the same entries, in any order.
+   * @param rhs Another map to compare with.
+   * @return true if this and rhs are not equal, otherwise false.
+   */
+  bool operator!= (const vl_hash_map &rhs) const noexcept (false)
+  {
+    return !(*this == rhs);
+  }
+
+ private:
+  /************* Private Methods **************/
+
+  /**
+   * Inserts an entry, and assigns the value to the key if it's new or if
+   * Assign is true.
+   * @tparam Assign true to assign the value to a key that is already there.
+   * @param key The key of the entry.
+   * @param value The value of the entry.
+   * @return An iterator to the entry of the key, and true if it was
+   *         inserted.
+   */
+  template<const bool Assign>
+  std::pair<iterator, bool> put (const K &key, const V &value)
+  noexcept (false)
+  {
+    if (this->_growth_left == 0)
+      {
+        // inserting may rehash, which moves the values, so copy value
+        // first, which may be one.
+        const V copy (value);
+        const std::pair<size_t, bool> result = this->insert_slot (key);
+        if (Assign || result.second)
+          {
+            _values.data ()[result.first] = copy;
+          }
+        return {iterator (this, _values.data (), result.first),
+                result.second};
+      }
+    const std::pair<size_t, bool> result = this->insert_slot (key);
+    if (Assign || result.second)
+      {
+        _values.data ()[result.first] = value;
+      }
+    return {iterator (this, _values.data (), result.first), result.second};
+  }
+};
+
+#endif //_VL_HASH_MAP_H_
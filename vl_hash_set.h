@@ -0,0 +1,222 @@
+#ifndef _VL_HASH_SET_H_
+#define _VL_HASH_SET_H_
+
+#include "vl_hash_table.h"
+#include <iterator>
+
+/**
+ * Represents a set of unique keys in an open addressing hash table (see
+ * vl_hash_table). Up to N keys fit in the slots on the stack, so small sets
+ * never allocate; beyond that the slots move to the heap, like a vl_vector
+ * that spills.
+ * @tparam K The type of the keys.
+ * @tparam N How much keys fit on the stack.
+ *           Unlike vl_vector, the default is a count and not a byte
+ *           budget: the slots come in whole groups of HASH_GROUP, so even
+ *           the smallest table takes more than DEFAULT_STATIC_BYTES.
+ * @tparam Hash Hashes the keys.
+ * @tparam KeyEqual Compares the keys.
+ */
+template<typename K, const size_t N = DEFAULT_STATIC_CAPACITY,
+    typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class vl_hash_set : public vl_hash_table<K, vl_hash_slots (N), Hash,
+                                         KeyEqual> {
+ public:
+  /************* Iterator **************/
+  using key_type = K;
+  using value_type = K;
+
+  /**
+   * A forward iterator over the keys of the set, in the order of their
+   * slots.
+   */
+  class const_iterator {
+   private:
+    const vl_hash_set *_set; // the set.
+    size_t _slot; // the slot of the current key, or capacity () at end.
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = K;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const K *;
+    using reference = const K &;
+
+    /**
+     * Constructs an iterator to the key in a slot.
+     * @param set A set.
+     * @param slot A used slot of the set, or its capacity ().
+     */
+    const_iterator (const vl_hash_set *set, const size_t slot) :
+        _set (set), _slot (slot)
+    {}
+
+    /**
+     * @return the slot of the current key.
+     */
+    size_t slot () const noexcept (true)
+    {
+      return _slot;
+    }
+
+    reference operator* () const noexcept (true)
+    {
+      return _set->_keys.data ()[_slot];
+    }
+
+    pointer operator-> () const noexcept (true)
+    {
+      return &**this;
+    }
+
+    const_iterator &operator++ () noexcept (true)
+    {
+      _slot = _set->next_used (_slot + 1);
+      return *this;
+    }
+
+    const_iterator operator++ (int) noexcept (true)
+    {
+      const_iterator it = *this;
+      ++*this;
+      return it;
+    }
+
+    bool operator== (const const_iterator &rhs) const noexcept (true)
+    {
+      return _slot == rhs._slot;
+    }
+
+    bool operator!= (const const_iterator &rhs) const noexcept (true)
+    {
+      return _slot != rhs._slot;
+    }
+  };
+
+  using iterator = const_iterator; // keys can't be changed in place.
+
+  /************* Constructors **************/
+
+  /**
+   * Default constructor which initializes an empty set.
+   */
+  vl_hash_set () = default;
+
+  /**
+   * Sequence based constructor. Inserts the keys of the range
+   * [first, last).
+   * @tparam ForwardIterator the type of iterator.
+   * @param first An iterator that represents the first key.
+   * @param last An iterator that represents the last key.
+   */
+  template<class ForwardIterator>
+  vl_hash_set (ForwardIterator first, ForwardIterator last)
+  {
+    for (; first != last; ++first)
+      {
+        insert (*first);
+      }
+  }
+
+  /**
+   * @return an iterator to the first key.
+   */
+  const_iterator begin () const noexcept (true)
+  {
+    return const_iterator (this, this->next_used (0));
+  }
+
+  /**
+   * @return an iterator past the last key.
+   */
+  const_iterator end () const noexcept (true)
+  {
+    return const_iterator (this, this->capacity ());
+  }
+
+  /************* Public Methods **************/
+
+  /**
+   * @param key A key.
+   * @return an iterator to the key, or end () if it isn't in the set.
+   */
+  const_iterator find (const K &key) const noexcept (false)
+  {
+    return const_iterator (this, this->find_slot (key, this->hash_of (key)));
+  }
+
+  /**
+   * Inserts a key, unless the set already contains it.
+   * @param key A key to insert.
+   * @return An iterator to the key in the set, and true if it was
+   *         inserted.
+   */
+  std::pair<const_iterator, bool> insert (const K &key) noexcept (false)
+  {
+    const std::pair<size_t, bool> result = this->insert_slot (key);
+    return {const_iterator (this, result.first), result.second};
+  }
+
+  /**
+   * Deletes the key that 'it' points at from the set.
+   * @param it An iterator to a key in the set.
+   * @return An iterator to the key after the deleted key.
+   */
+  const_iterator erase (const_iterator it) noexcept (false)
+  {
+    this->erase_slot (it.slot ());
+    return const_iterator (this, this->next_used (it.slot () + 1));
+  }
+
+  /**
+   * Deletes the key from the set, if it's there.
+   * @param key A key to delete.
+   * @return 1 if the key was deleted, otherwise 0.
+   */
+  size_t erase (const K &key) noexcept (false)
+  {
+    const size_t slot = this->find_slot (key, this->hash_of (key));
+    if (slot == this->capacity ())
+      {
+        return 0;
+      }
+    this->erase_slot (slot);
+    return 1;
+  }
+
+  /************* Operators Overloading **************/
+
+  /**
+   * Checks if both sets contain the same keys, in any order.
+   * @param rhs Another set to compare with.
+   * @return true if this and rhs are equal, otherwise false.
+   */
+  bool operator== (const vl_hash_set &rhs) const noexcept (false)
+  {
+    if (this->size () != rhs.size ())
+      {
+        return false;
+      }
+    for (const K &key : *this)
+      {
+        if (!rhs.contains (key))
+          {
+            return false;
+          }
+      }
+    return true;
+  }
+
+  /**
+   * Checks if both sets contain the same keys, in any order.
+   * @param rhs Another set to compare with.
+   * @return true if this and rhs are not equal, otherwise false.
+   */
+  bool operator!= (const vl_hash_set &rhs) const noexcept (false)
+  {
+    return !(*this == rhs);
+  }
+
+};
+
+#endif //_VL_HASH_SET_H_
@@ -0,0 +1,404 @@
+#ifndef _VL_HASH_TABLE_H_
+#define _VL_HASH_TABLE_H_
+
+#include "vl_vector.h"
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define HASH_GROUP 16 // slots whose control bytes are probed at once.
+#define HASH_EMPTY ((int8_t) -128) // control byte of a slot never used.
+#define HASH_DELETED ((int8_t) -2) // control byte of an erased slot.
+
+/**
+ * How much slots a hash table needs for N keys: a power of 2, and at least
+ * one group, that is at most 7/8 full with N keys.
+ * @param N Number of keys.
+ * @return The number of slots.
+ */
+constexpr size_t vl_hash_slots (const size_t N) noexcept (true)
+{
+  size_t slots = HASH_GROUP;
+  while (slots / 8 * 7 < N)
+    {
+      slots *= 2;
+    }
+  return slots;
+}
+
+/**
+ * Spreads a hash over all the bits, since std::hash of integers is the
+ * identity, and both the low 7 bits and the rest of the hash are used.
+ * @param h A hash.
+ * @return The mixed hash.
+ */
+inline size_t vl_hash_mix (size_t h) noexcept (true)
+{
+  h *= (size_t) 0x9E3779B97F4A7C15ull;
+  return h ^ (h >> (4 * sizeof (size_t)));
+}
+
+/**
+ * @param group The control bytes of a group, aligned to HASH_GROUP.
+ * @param byte A control byte.
+ * @return A mask with bit l set if byte l of the group equals byte.
+ */
+inline uint32_t vl_group_match (const int8_t *group, const int8_t byte)
+noexcept (true)
+{
+#ifdef __SSE2__
+  const __m128i ctrl =
+      _mm_load_si128 (reinterpret_cast<const __m128i *> (group));
+  return (uint32_t) _mm_movemask_epi8 (
+      _mm_cmpeq_epi8 (ctrl, _mm_set1_epi8 (byte)));
+#else
+  uint32_t mask = 0;
+  for (size_t l = 0; l < HASH_GROUP; ++l)
+    {
+      mask |= (uint32_t) (group[l] == byte) << l;
+    }
+  return mask;
+#endif
+}
+
+/**
+ * @param group The control bytes of a group, aligned to HASH_GROUP.
+ * @return A mask with bit l set if slot l of the group is free, either
+ *         empty or deleted; these are the control bytes with the sign bit.
+ */
+inline uint32_t vl_group_free (const int8_t *group) noexcept (true)
+{
+#ifdef __SSE2__
+  return (uint32_t) _mm_movemask_epi8 (
+      _mm_load_si128 (reinterpret_cast<const __m128i *> (group)));
+#else
+  uint32_t mask = 0;
+  for (size_t l = 0; l < HASH_GROUP; ++l)
+    {
+      mask |= (uint32_t) (group[l] < 0) << l;
+    }
+  return mask;
+#endif
+}
+
+/**
+ * The keys of an open addressing hash table in the style of Swiss tables.
+ * Every slot has a control byte: empty, deleted, or the low 7 bits of the
+ * hash of its key. The slots are probed a group at a time, comparing the
+ * HASH_GROUP control bytes of the group with a single SIMD instruction, so
+ * keys are only compared when their control bytes match. The control bytes
+ * and the keys are held in vl_vectors, so the slots are on the stack until
+ * the table outgrows Slots, then on the heap. Every slot holds a
+ * constructed key, so K must be default constructible, and an erased slot
+ * gets K ().
+ * @tparam K The type of the keys.
+ * @tparam Slots How much slots can be on the stack, a power of 2.
+ * @tparam Hash Hashes the keys.
+ * @tparam KeyEqual Compares the keys.
+ */
+template<typename K, const size_t Slots, typename Hash, typename KeyEqual>
+class vl_hash_table {
+  static_assert (std::is_default_constructible<K>::value,
+                 "K must be default constructible, every slot holds one");
+
+ protected:
+  /************* Protected Fields **************/
+  vl_vector<int8_t, Slots, HASH_GROUP> _ctrl; // the control byte of a slot.
+  vl_vector<K, Slots> _keys; // the key in a slot.
+  size_t _size; // number of keys in the table.
+  size_t _growth_left; // empty slots that can be used before a rehash.
+  Hash _hash; // hashes the keys.
+  KeyEqual _eq; // compares the keys.
+
+  /************* Protected Constructors **************/
+
+  /**
+   * Initializes an empty table on the stack.
+   */
+  vl_hash_table () : _size (0), _growth_left (Slots / 8 * 7)
+  {
+    _ctrl.resize (Slots, HASH_EMPTY);
+    _keys.resize (Slots);
+  }
+
+  vl_hash_table (const vl_hash_table &) = default;
+  vl_hash_table (vl_hash_table &&) noexcept (true) = default;
+  vl_hash_table &operator= (const vl_hash_table &) = default;
+  vl_hash_table &operator= (vl_hash_table &&) noexcept (true) = default;
+
+  /************* Protected Methods **************/
+
+  /**
+   * @param key A key.
+   * @return The mixed hash of the key.
+   */
+  size_t hash_of (const K &key) const noexcept (false)
+  {
+    return vl_hash_mix (_hash (key));
+  }
+
+  /**
+   * @param groups The number of groups in a table, a power of 2.
+   * @param h A mixed hash.
+   * @param i How much groups were probed so far.
+   * @return The index of the i-th group that the probe of h visits; the
+   *         probe visits every group once in its first groups steps.
+   */
+  static size_t probe (const size_t groups, const size_t h, const size_t i)
+  noexcept (true)
+  {
+    return ((h >> 7) + i * (i + 1) / 2) & (groups - 1);
+  }
+
+  /**
+   * @param key A key.
+   * @param h The mixed hash of the key.
+   * @return The slot of the key, or capacity () if it isn't in the table.
+   */
+  size_t find_slot (const K &key, const size_t h) const noexcept (false)
+  {
+    const int8_t *ctrl = _ctrl.data ();
+    const K *keys = _keys.data ();
+    const size_t groups = capacity () / HASH_GROUP;
+    for (size_t i = 0;; ++i)
+      {
+        const size_t first = probe (groups, h, i) * HASH_GROUP;
+        for (uint32_t m = vl_group_match (ctrl + first, (int8_t) (h & 0x7F));
+             m != 0; m &= m - 1)
+          {
+            const size_t slot = first + __builtin_ctz (m);
+            if (_eq (keys[slot], key))
+              {
+                return slot;
+              }
+          }
+        if (vl_group_match (ctrl + first, HASH_EMPTY) != 0)
+          {
+            return capacity ();
+          }
+      }
+  }
+
+  /**
+   * @param ctrl The control bytes of a table with capacity slots.
+   * @param capacity The number of slots in the table.
+   * @param h A mixed hash.
+   * @return The first free slot in the probe of h.
+   */
+  static size_t free_slot (const int8_t *ctrl, const size_t capacity,
+                           const size_t h) noexcept (true)
+  {
+    const size_t groups = capacity / HASH_GROUP;
+    for (size_t i = 0;; ++i)
+      {
+        const size_t first = probe (groups, h, i) * HASH_GROUP;
+        const uint32_t m = vl_group_free (ctrl + first);
+        if (m != 0)
+          {
+            return first + __builtin_ctz (m);
+          }
+      }
+  }
+
+  /**
+   * Moves the keys to a new table of new_cap slots, which drops the
+   * deleted slots.
+   * @tparam Relocate A callable that takes the old and the new slot of
+   *                  every key.
+   * @param new_cap The number of slots of the new table, a power of 2 and at
+   *                least Slots.
+   * @param relocate Called for every key after it's moved.
+   */
+  template<typename Relocate>
+  void rehash_keys (const size_t new_cap, Relocate relocate) noexcept (false)
+  {
+    vl_vector<int8_t, Slots, HASH_GROUP> ctrl;
+    vl_vector<K, Slots> keys;
+    ctrl.reserve (new_cap);
+    ctrl.resize (new_cap, HASH_EMPTY);
+    keys.reserve (new_cap);
+    keys.resize (new_cap);
+    const int8_t *old_ctrl = _ctrl.data ();
+    K *old_keys = _keys.data ();
+    for (size_t slot = 0; slot < capacity (); ++slot)
+      {
+        if (old_ctrl[slot] >= 0)
+          {
+            const size_t h = hash_of (old_keys[slot]);
+            const size_t to = free_slot (ctrl.data (), new_cap, h);
+            ctrl.data ()[to] = (int8_t) (h & 0x7F);
+            keys.data ()[to] = std::move (old_keys[slot]);
+            relocate (slot, to);
+          }
+      }
+    _ctrl = std::move (ctrl);
+    _keys = std::move (keys);
+    _growth_left = new_cap / 8 * 7 - _size;
+  }
+
+  /**
+   * Moves the keys to a new table of new_cap slots. A derived table that
+   * keeps more per slot moves it along.
+   * @param new_cap The number of slots of the new table.
+   */
+  virtual void rehash (const size_t new_cap) noexcept (false)
+  {
+    rehash_keys (new_cap, [] (size_t, size_t) {});
+  }
+
+  /**
+   * Finds the slot of a key, or puts the key in a free slot, after a rehash
+   * if there is no room: to twice the slots, or to the same number of slots
+   * when most of the used slots are deleted.
+   * @param key A key.
+   * @return The slot of the key, and true if it was inserted.
+   */
+  std::pair<size_t, bool> insert_slot (const K &key) noexcept (false)
+  {
+    const size_t h = hash_of (key);
+    const size_t found = find_slot (key, h);
+    if (found != capacity ())
+      {
+        return {found, false};
+      }
+    if (_growth_left == 0)
+      {
+        // rehashing moves the keys, so copy key first, which may be one.
+        const K copy (key);
+        rehash ((_size * 2 <= capacity () / 8 * 7) ?
+                capacity () : 2 * capacity ());
+        return insert_slot (copy);
+      }
+    const size_t slot = free_slot (_ctrl.data (), capacity (), h);
+    if (_ctrl.data ()[slot] == HASH_EMPTY)
+      {
+        --_growth_left;
+      }
+    _ctrl.data ()[slot] = (int8_t) (h & 0x7F);
+    _keys.data ()[slot] = key;
+    ++_size;
+    return {slot, true};
+  }
+
+  /**
+   * Frees a used slot. It's marked empty if its group has an empty slot,
+   * since then no probe went past the group, otherwise deleted.
+   * @param slot A used slot.
+   */
+  void erase_slot (const size_t slot) noexcept (false)
+  {
+    int8_t *ctrl = _ctrl.data ();
+    const size_t first = slot / HASH_GROUP * HASH_GROUP;
+    if (vl_group_match (ctrl + first, HASH_EMPTY) != 0)
+      {
+        ctrl[slot] = HASH_EMPTY;
+        ++_growth_left;
+      }
+    else
+      {
+        ctrl[slot] = HASH_DELETED;
+      }
+    _keys.data ()[slot] = K ();
+    --_size;
+  }
+
+  /**
+   * @param slot A slot, or capacity ().
+   * @return The first used slot from slot onwards, or capacity ().
+   */
+  size_t next_used (size_t slot) const noexcept (true)
+  {
+    const int8_t *ctrl = _ctrl.data ();
+    while (slot < capacity () && ctrl[slot] < 0)
+      {
+        ++slot;
+      }
+    return slot;
+  }
+
+ public:
+  /************* Public Methods **************/
+
+  /**
+   * Destructor.
+   */
+  virtual ~vl_hash_table () = default;
+
+  /**
+   * @return the number of keys in the table.
+   */
+  size_t size () const noexcept (true)
+  {
+    return _size;
+  }
+
+  /**
+   * @return true if the table is empty, otherwise false.
+   */
+  bool empty () const noexcept (true)
+  {
+    return _size == 0;
+  }
+
+  /**
+   * @return the number of slots in the table.
+   */
+  size_t capacity () const noexcept (true)
+  {
+    return _ctrl.size ();
+  }
+
+  /**
+   * Makes sure the table can hold at least n keys without a rehash.
+   * @param n The requested number of keys.
+   */
+  void reserve (const size_t n) noexcept (false)
+  {
+    size_t new_cap = capacity ();
+    while (new_cap / 8 * 7 < n)
+      {
+        new_cap *= 2;
+      }
+    if (new_cap != capacity ())
+      {
+        rehash (new_cap);
+      }
+  }
+
+  /**
+   * @param key A key.
+   * @return true if the table contains the key, otherwise false.
+   */
+  bool contains (const K &key) const noexcept (false)
+  {
+    return find_slot (key, hash_of (key)) != capacity ();
+  }
+
+  /**
+   * @param key A key.
+   * @return 1 if the table contains the key, otherwise 0.
+   */
+  size_t count (const K &key) const noexcept (false)
+  {
+    return contains (key) ? 1 : 0;
+  }
+
+  /**
+   * Deletes all the keys, and goes back to the stack.
+   */
+  virtual void clear () noexcept (false)
+  {
+    _ctrl.clear ();
+    _ctrl.resize (Slots, HASH_EMPTY);
+    _keys.clear ();
+    _keys.resize (Slots);
+    _size = 0;
+    _growth_left = Slots / 8 * 7;
+  }
+};
+
+#endif //_VL_HASH_TABLE_H_
@@ -0,0 +1,495 @@
+#ifndef _VL_MEMORY_H_
+#define _VL_MEMORY_H_
+
+#include "vl_thread_pool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#define HUGE_PAGE_SIZE ((size_t) 2 * 1024 * 1024)
+// allocations of at least this many bytes are mapped on huge pages.
+#ifndef HUGE_PAGE_THRESHOLD
+#define HUGE_PAGE_THRESHOLD (32 * HUGE_PAGE_SIZE)
+#endif
+// bulk copies and fills of at least this many bytes bypass the cache.
+#ifndef STREAMING_THRESHOLD
+#define STREAMING_THRESHOLD ((size_t) 4 * 1024 * 1024)
+#endif
+#define STREAM_WIDTH 16
+// default size from which bulk copies and fills are split between threads.
+#ifndef PARALLEL_THRESHOLD
+#define PARALLEL_THRESHOLD ((size_t) 64 * 1024 * 1024)
+#endif
+// the chunks of split copies and fills start on boundaries of this size.
+#define PARALLEL_CHUNK_SIZE ((size_t) 4096)
+
+/**
+ * Controls the parallel path of bulk copies and fills (vl_bulk_copy and
+ * vl_bulk_fill), which back the copy constructor, assignment and fill
+ * constructor of vl_vector. They are split between the workers of
+ * vl_thread_pool::instance (), the pool of the vl_parallel algorithms, so
+ * the number of threads is at most PARALLEL_THREADS, and threads caps it at
+ * run time. It's off until it's enabled.
+ */
+struct vl_parallel_config {
+  size_t threshold; // copies and fills of at least this many bytes split.
+  bool enabled; // false keeps every copy and fill on the calling thread.
+  size_t threads; // most workers a copy or fill is split between, 0 for all.
+};
+
+/**
+ * @return the process wide parallel configuration, which should be set
+ *         before vectors are copied concurrently.
+ */
+inline vl_parallel_config &vl_parallel_settings () noexcept (true)
+{
+  static vl_parallel_config config{PARALLEL_THRESHOLD, false, 0};
+  return config;
+}
+
+/**
+ * @param bytes A size of an allocation.
+ * @return true if an allocation of this size is mapped on huge pages,
+ *         otherwise false. Always false outside of Linux.
+ */
+inline bool vl_is_huge (const size_t bytes) noexcept (true)
+{
+#ifdef __linux__
+  return bytes >= HUGE_PAGE_THRESHOLD;
+#else
+  (void) bytes;
+  return false;
+#endif
+}
+
+/**
+ * @param bytes A size of an allocation.
+ * @return bytes rounded up to a whole number of huge pages.
+ */
+inline size_t vl_huge_length (const size_t bytes) noexcept (true)
+{
+  return (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+}
+
+/**
+ * Maps anonymous memory that starts on a huge page boundary, and asks the
+ * kernel to back it with transparent huge pages, which cuts TLB misses
+ * when scanning it.
+ * @param bytes The size of the memory.
+ * @return A pointer to the memory.
+ */
+inline void *vl_map_huge (const size_t bytes) noexcept (false)
+{
+#ifdef __linux__
+  const size_t len = vl_huge_length (bytes);
+  // map one more huge page, so the mapping can be trimmed to a boundary.
+  void *map = mmap (nullptr, len + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (map == MAP_FAILED)
+    {
+      throw std::bad_alloc ();
+    }
+  char *first = static_cast<char *> (map);
+  char *aligned = reinterpret_cast<char *> (
+      (reinterpret_cast<size_t> (first) + HUGE_PAGE_SIZE - 1)
+      & ~(HUGE_PAGE_SIZE - 1));
+  if (aligned != first)
+    {
+      munmap (first, aligned - first);
+    }
+  if (first + HUGE_PAGE_SIZE != aligned)
+    {
+      munmap (aligned + len, first + HUGE_PAGE_SIZE - aligned);
+    }
+  madvise (aligned, len, MADV_HUGEPAGE);
+  return aligned;
+#else
+  (void) bytes;
+  throw std::bad_alloc ();
+#endif
+}
+
+/**
+ * Grows memory that was mapped by vl_map_huge with mremap, which moves the
+ * pages instead of copying their content when it can't grow in place.
+ * The result is page aligned, though not always huge page aligned.
+ * @param data A pointer to the memory.
+ * @param old_bytes The size the memory was allocated with.
+ * @param new_bytes The new size, at least HUGE_PAGE_THRESHOLD.
+ * @return A pointer to the grown memory, or nullptr if it can't be grown
+ *         this way, in which case data is still valid.
+ */
+inline void *vl_remap_huge (void *data, const size_t old_bytes,
+                            const size_t new_bytes) noexcept (true)
+{
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+  if (!vl_is_huge (old_bytes) || !vl_is_huge (new_bytes))
+    {
+      return nullptr;
+    }
+  void *map = mremap (data, vl_huge_length (old_bytes),
+                      vl_huge_length (new_bytes), MREMAP_MAYMOVE);
+  return (map == MAP_FAILED) ? nullptr : map;
+#else
+  (void) data;
+  (void) old_bytes;
+  (void) new_bytes;
+  return nullptr;
+#endif
+}
+
+/**
+ * Frees memory that was allocated for 'bytes' bytes, either by
+ * vl_map_huge or by the aligned operator new, depending on its size.
+ * @param data A pointer to the memory.
+ * @param bytes The size the memory was allocated with.
+ * @param alignment The alignment the memory was allocated with.
+ */
+inline void vl_free (void *data, const size_t bytes, const size_t alignment)
+noexcept (true)
+{
+#ifdef __linux__
+  if (vl_is_huge (bytes))
+    {
+      munmap (data, vl_huge_length (bytes));
+      return;
+    }
+#endif
+  ::operator delete (data, std::align_val_t (alignment));
+}
+
+/**
+ * Gives the kernel a hint about how memory of 'bytes' bytes will be
+ * accessed, for example MADV_SEQUENTIAL before a scan or MADV_WILLNEED
+ * before it's read. Only memory mapped on huge pages takes hints.
+ * @param data A pointer to the memory.
+ * @param bytes The size the memory was allocated with.
+ * @param advice An madvise advice.
+ * @return true if the hint was given, otherwise false.
+ */
+inline bool vl_advise (void *data, const size_t bytes, const int advice)
+noexcept (true)
+{
+#ifdef __linux__
+  if (data != nullptr && vl_is_huge (bytes))
+    {
+      return madvise (data, vl_huge_length (bytes), advice) == 0;
+    }
+#endif
+  (void) data;
+  (void) bytes;
+  (void) advice;
+  return false;
+}
+
+/**
+ * Allocates heap memory for n elements of type T, aligned to 'alignment'
+ * bytes, and default initializes them like new T[n] does. Allocations of
+ * at least HUGE_PAGE_THRESHOLD bytes are mapped on huge pages.
+ * @tparam T The type of the elements.
+ * @param n Number of elements.
+ * @param alignment The alignment of the memory, a power of 2.
+ * @return A pointer to the first element.
+ */
+template<typename T>
+T *vl_allocate (const size_t n, const size_t alignment) noexcept (false)
+{
+  const size_t bytes = n * sizeof (T);
+  T *data = static_cast<T *> (
+      vl_is_huge (bytes) ? vl_map_huge (bytes) :
+      ::operator new (bytes, std::align_val_t (alignment)));
+  try
+    {
+      std::uninitialized_default_construct_n (data, n);
+    }
+  catch (...)
+    {
+      vl_free (data, bytes, alignment);
+      throw;
+    }
+  return data;
+}
+
+/**
+ * Destroys n elements that were allocated by vl_allocate, and frees their
+ * memory. Does nothing if data is nullptr.
+ * @tparam T The type of the elements.
+ * @param data A pointer to the first element.
+ * @param n Number of elements that were allocated.
+ * @param alignment The alignment the memory was allocated with.
+ */
+template<typename T>
+void vl_deallocate (T *data, const size_t n, const size_t alignment)
+noexcept (true)
+{
+  if (data == nullptr)
+    {
+      return;
+    }
+  std::destroy_n (data, n);
+  vl_free (data, n * sizeof (T), alignment);
+}
+
+/**
+ * Tries to grow memory that was allocated by vl_allocate for old_n
+ * elements to new_n elements without copying them, by remapping its pages.
+ * This is possible only for trivially copyable types whose memory is mapped
+ * on huge pages, and an alignment no larger than a page. The elements keep
+ * their values and the new ones are default initialized.
+ * @tparam T The type of the elements.
+ * @param data A pointer to the first element.
+ * @param old_n Number of elements that were allocated.
+ * @param new_n Number of elements to grow to, larger than old_n.
+ * @param alignment The alignment the memory was allocated with.
+ * @return A pointer to the first element of the grown memory, or nullptr
+ *         if it can't be grown this way, in which case data is still valid.
+ */
+template<typename T>
+T *vl_try_reallocate (T *data, const size_t old_n, const size_t new_n,
+                      const size_t alignment) noexcept (true)
+{
+#ifdef __linux__
+  if (!std::is_trivially_copyable<T>::value
+      || alignment > (size_t) sysconf (_SC_PAGESIZE))
+    {
+      return nullptr;
+    }
+  T *grown = static_cast<T *> (
+      vl_remap_huge (data, old_n * sizeof (T), new_n * sizeof (T)));
+  if (grown != nullptr)
+    {
+      std::uninitialized_default_construct (grown + old_n, grown + new_n);
+    }
+  return grown;
+#else
+  (void) data;
+  (void) old_n;
+  (void) new_n;
+  (void) alignment;
+  return nullptr;
+#endif
+}
+
+/**
+ * @tparam T The type of the elements.
+ * @param n Number of elements.
+ * @return true if memory that vl_allocate gives for n elements is known to
+ *         hold only zero bytes, which is the case for fresh huge page
+ *         mappings of types that default initialization doesn't touch.
+ */
+template<typename T>
+bool vl_is_zeroed (const size_t n) noexcept (true)
+{
+  return std::is_trivially_default_constructible<T>::value
+         && vl_is_huge (n * sizeof (T));
+}
+
+/**
+ * @tparam T The type of the value.
+ * @param v A value.
+ * @return true if T is trivially copyable and all the bytes of v are zero,
+ *         otherwise false.
+ */
+template<typename T>
+bool vl_is_zero (const T &v) noexcept (true)
+{
+  if (!std::is_trivially_copyable<T>::value)
+    {
+      return false;
+    }
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *> (&v);
+  return std::all_of (bytes, bytes + sizeof (T),
+                      [] (unsigned char b) { return b == 0; });
+}
+
+/**
+ * Copies 'bytes' bytes with non-temporal stores, which write around the
+ * cache instead of evicting the working set to make room for data that
+ * won't be read soon. Plain memcpy is used without SSE2.
+ * @param dst The destination.
+ * @param src The source, which must not overlap dst.
+ * @param bytes Number of bytes to copy.
+ */
+inline void vl_stream_copy (void *dst, const void *src, size_t bytes)
+noexcept (true)
+{
+#ifdef __SSE2__
+  char *d = static_cast<char *> (dst);
+  const char *s = static_cast<const char *> (src);
+  // the stores must be aligned, so copy the head up to a boundary first.
+  size_t head = (STREAM_WIDTH - (uintptr_t) d % STREAM_WIDTH) % STREAM_WIDTH;
+  head = std::min (head, bytes);
+  memcpy (d, s, head);
+  d += head;
+  s += head;
+  bytes -= head;
+  for (; bytes >= STREAM_WIDTH; bytes -= STREAM_WIDTH)
+    {
+      __m128i chunk = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (s));
+      _mm_stream_si128 (reinterpret_cast<__m128i *> (d), chunk);
+      d += STREAM_WIDTH;
+      s += STREAM_WIDTH;
+    }
+  memcpy (d, s, bytes);
+  _mm_sfence ();
+#else
+  memcpy (dst, src, bytes);
+#endif
+}
+
+/**
+ * Fills n elements with the value v using non-temporal stores, when the
+ * size of T divides the store width. Otherwise uses std::fill_n.
+ * @tparam T A trivially copyable type.
+ * @param dst The first element to fill.
+ * @param n Number of elements to fill.
+ * @param v The value to fill with.
+ */
+template<typename T>
+void vl_stream_fill (T *dst, size_t n, const T &v) noexcept (true)
+{
+#ifdef __SSE2__
+  if constexpr (STREAM_WIDTH % sizeof (T) == 0)
+    {
+      const size_t per_store = STREAM_WIDTH / sizeof (T);
+      while (n > 0 && (uintptr_t) dst % STREAM_WIDTH != 0)
+        {
+          *dst++ = v;
+          --n;
+        }
+      alignas (STREAM_WIDTH) T pattern[STREAM_WIDTH / sizeof (T)];
+      std::fill_n (pattern, per_store, v);
+      __m128i p = _mm_load_si128 (reinterpret_cast<const __m128i *> (pattern));
+      for (; n >= per_store; n -= per_store)
+        {
+          _mm_stream_si128 (reinterpret_cast<__m128i *> (dst), p);
+          dst += per_store;
+        }
+      _mm_sfence ();
+    }
+#endif
+  std::fill_n (dst, n, v);
+}
+
+/**
+ * Splits the n elements at dst into a chunk for every worker of
+ * vl_thread_pool::instance (), up to the threads of the parallel
+ * configuration, and calls fn (first, count) for each chunk
+ * on the pool. Every chunk but the first starts at the first element at or
+ * after a PARALLEL_CHUNK_SIZE boundary of the address of dst, so workers
+ * don't store to the same pages, except for an element that straddles a
+ * boundary. Runs fn (0, n) on the calling thread when the elements take
+ * less than the threshold, the parallel path is off, or it may use only
+ * one thread. fn must not throw.
+ * @tparam T The type of the elements.
+ * @tparam Fn A callable that takes the index of the first element of a
+ *            chunk and the number of its elements.
+ * @param dst The elements that are written.
+ * @param n Number of elements.
+ * @param fn The function to run on each chunk.
+ */
+template<typename T, typename Fn>
+void vl_parallel_chunks (const T *dst, const size_t n, const Fn &fn)
+noexcept (false)
+{
+  const vl_parallel_config &config = vl_parallel_settings ();
+  const size_t bytes = n * sizeof (T);
+  if (!config.enabled || bytes < config.threshold || config.threads == 1)
+    {
+      fn ((size_t) 0, n);
+      return;
+    }
+  vl_thread_pool &pool = vl_thread_pool::instance ();
+  const size_t threads = (config.threads != 0) ?
+                         std::min (config.threads, pool.size ()) : pool.size ();
+  const size_t chunk_bytes = (bytes + threads - 1) / threads;
+  const size_t chunks = (bytes + chunk_bytes - 1) / chunk_bytes;
+  const uintptr_t start = reinterpret_cast<uintptr_t> (dst);
+  // the index of the first element of chunk i.
+  auto boundary = [=] (const size_t i) {
+    if (i == chunks)
+      {
+        return n;
+      }
+    const uintptr_t page = (start + i * chunk_bytes + PARALLEL_CHUNK_SIZE - 1)
+                           & ~(PARALLEL_CHUNK_SIZE - 1);
+    return std::min (n, (size_t) (page - start + sizeof (T) - 1) / sizeof (T));
+  };
+  pool.run (chunks, [&fn, &boundary] (size_t i) {
+    const size_t first = (i == 0) ? 0 : boundary (i);
+    const size_t last = boundary (i + 1);
+    if (first < last)
+      {
+        fn (first, last - first);
+      }
+  });
+}
+
+/**
+ * Copies [first, last) to dst, with non-temporal stores when T is trivially
+ * copyable and the range is at least STREAMING_THRESHOLD bytes, split
+ * between threads when it's at least the parallel threshold.
+ * @tparam T The type of the elements.
+ * @param first The first element to copy.
+ * @param last The element after the last one to copy.
+ * @param dst Where to copy to, which must not overlap the range.
+ */
+template<typename T>
+void vl_bulk_copy (const T *first, const T *last, T *dst) noexcept (false)
+{
+  const size_t bytes = (last - first) * sizeof (T);
+  if constexpr (std::is_trivially_copyable<T>::value)
+    {
+      if (bytes >= STREAMING_THRESHOLD)
+        {
+          vl_parallel_chunks (
+              dst, last - first, [=] (size_t i, size_t count)
+              {
+                vl_stream_copy (dst + i, first + i, count * sizeof (T));
+              });
+          return;
+        }
+    }
+  std::copy (first, last, dst);
+}
+
+/**
+ * Fills n elements with the value v, with non-temporal stores when T is
+ * trivially copyable and the elements take at least STREAMING_THRESHOLD
+ * bytes, split between threads when they take at least the parallel
+ * threshold.
+ * @tparam T The type of the elements.
+ * @param dst The first element to fill.
+ * @param n Number of elements to fill.
+ * @param v The value to fill with.
+ */
+template<typename T>
+void vl_bulk_fill (T *dst, const size_t n, const T &v) noexcept (false)
+{
+  if constexpr (std::is_trivially_copyable<T>::value)
+    {
+      if (n * sizeof (T) >= STREAMING_THRESHOLD)
+        {
+          vl_parallel_chunks (dst, n,
+                              [dst, &v] (size_t i, size_t count)
+                              {
+                                vl_stream_fill (dst + i, count, v);
+                              });
+          return;
+        }
+    }
+  std::fill_n (dst, n, v);
+}
+
+#endif //_VL_MEMORY_H_
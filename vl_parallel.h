@@ -0,0 +1,265 @@
+#ifndef _VL_PARALLEL_H_
+#define _VL_PARALLEL_H_
+
+#include "vl_thread_pool.h"
+#include "vl_vector.h"
+#include <functional>
+#include <numeric>
+
+// vectors with less elements than this are processed on the calling thread.
+#ifndef PARALLEL_CUTOFF
+#define PARALLEL_CUTOFF ((size_t) 32 * 1024)
+#endif
+// how much chunks the work is split into for every thread of the pool.
+#define PARALLEL_TASKS_PER_THREAD 4
+
+/**
+ * Parallel versions of standard algorithms over any vl_vector (or anything
+ * else with data () and size ()). They split the elements into contiguous
+ * chunks that run on vl_thread_pool::instance (), and fall back to the
+ * serial algorithm below PARALLEL_CUTOFF elements. The given functions
+ * run concurrently and must not throw.
+ */
+namespace vl_parallel {
+
+/**
+ * Runs fn (i) for every i in [0, count) on the pool, and waits for all of
+ * them (see vl_thread_pool::run).
+ * @tparam Fn A callable that takes a task index.
+ * @param count Number of tasks.
+ * @param fn The function to run.
+ */
+template<typename Fn>
+void run_tasks (const size_t count, const Fn &fn) noexcept (false)
+{
+  if (count == 0)
+    {
+      return;
+    }
+  vl_thread_pool::instance ().run (count, fn);
+}
+
+/**
+ * @param n Number of elements.
+ * @return the size of the chunks n elements are split into, which is n
+ *         itself when they should be processed serially.
+ */
+inline size_t chunk_size (const size_t n) noexcept (false)
+{
+  const size_t threads = vl_thread_pool::instance ().size ();
+  if (n < PARALLEL_CUTOFF || threads <= 1)
+    {
+      return std::max (n, (size_t) 1);
+    }
+  const size_t chunks = threads * PARALLEL_TASKS_PER_THREAD;
+  return std::max ((n + chunks - 1) / chunks, PARALLEL_CUTOFF / 4);
+}
+
+/**
+ * Runs fn (index, first, last) for every chunk [first, last) of n elements.
+ * @tparam Fn A callable that takes the index of a chunk and its range.
+ * @param n Number of elements.
+ * @param fn The function to run.
+ * @return the number of chunks.
+ */
+template<typename Fn>
+size_t run_chunks (const size_t n, const Fn &fn) noexcept (false)
+{
+  const size_t chunk = chunk_size (n);
+  const size_t count = (n + chunk - 1) / chunk;
+  run_tasks (count, [&fn, chunk, n] (size_t i) {
+    fn (i, i * chunk, std::min (n, (i + 1) * chunk));
+  });
+  return count;
+}
+
+/**
+ * Calls fn on every element of the vector.
+ * @param v A vector.
+ * @param fn A function that takes a reference to an element.
+ */
+template<typename Vector, typename Fn>
+void for_each (Vector &v, Fn fn) noexcept (false)
+{
+  auto *data = v.data ();
+  run_chunks (v.size (), [data, &fn] (size_t, size_t first, size_t last) {
+    std::for_each (data + first, data + last, fn);
+  });
+}
+
+/**
+ * Stores fn (in[i]) in out[i] for every element of in.
+ * Throws std::out_of_range if out has less elements than in.
+ * @param in A vector to read.
+ * @param out A vector to write, which may be in itself.
+ * @param fn A function that takes an element of in and returns an element
+ *           of out.
+ */
+template<typename In, typename Out, typename Fn>
+void transform (const In &in, Out &out, Fn fn) noexcept (false)
+{
+  if (out.size () < in.size ())
+    {
+      throw std::out_of_range{"Output is smaller than input"};
+    }
+  const auto *src = in.data ();
+  auto *dst = out.data ();
+  run_chunks (in.size (), [src, dst, &fn] (size_t, size_t first,
+                                           size_t last) {
+    std::transform (src + first, src + last, dst + first, fn);
+  });
+}
+
+/**
+ * Combines all the elements of the vector and init with op, in an
+ * unspecified order, so op must be associative and commutative.
+ * @param v A vector.
+ * @param init The initial value.
+ * @param op A binary operation.
+ * @return The combination of init and all the elements.
+ */
+template<typename Vector, typename T, typename Op = std::plus<>>
+T reduce (const Vector &v, T init, Op op = Op ()) noexcept (false)
+{
+  const auto *data = v.data ();
+  const size_t n = v.size ();
+  if (n == 0)
+    {
+      return init;
+    }
+  vl_vector<T, 0> partials ((n + chunk_size (n) - 1) / chunk_size (n), init);
+  run_chunks (n, [data, &partials, &op] (size_t i, size_t first,
+                                         size_t last) {
+    T sum = data[first];
+    for (size_t j = first + 1; j < last; ++j)
+      {
+        sum = op (sum, data[j]);
+      }
+    partials[i] = sum;
+  });
+  return std::accumulate (partials.begin (), partials.end (), init, op);
+}
+
+/**
+ * Scans [first, last) of src into dst like std::inclusive_scan, but
+ * accumulates in T from the first element on, as the chunks after it do.
+ * @param src The elements to read.
+ * @param dst The elements to write, which may be src.
+ * @param first The index of the first element.
+ * @param last The index after the last element, greater than first.
+ * @param op An associative binary operation.
+ */
+template<typename T, typename In, typename Out, typename Op>
+void scan_first_chunk (const In *src, Out *dst, const size_t first,
+                       const size_t last, const Op &op) noexcept (false)
+{
+  const T init (src[first]);
+  dst[first] = init;
+  std::inclusive_scan (src + first + 1, src + last, dst + first + 1, op,
+                       init);
+}
+
+/**
+ * Stores in out[i] the combination with op of in[0], ..., in[i], which is
+ * accumulated in the value type of out.
+ * Throws std::out_of_range if out has less elements than in.
+ * @param in A vector to read.
+ * @param out A vector to write, which may be in itself.
+ * @param op An associative binary operation.
+ */
+template<typename In, typename Out, typename Op = std::plus<>>
+void inclusive_scan (const In &in, Out &out, Op op = Op ()) noexcept (false)
+{
+  using T = typename Out::value_type;
+  if (out.size () < in.size ())
+    {
+      throw std::out_of_range{"Output is smaller than input"};
+    }
+  const auto *src = in.data ();
+  auto *dst = out.data ();
+  const size_t n = in.size ();
+  const size_t chunk = chunk_size (n);
+  if (n == 0)
+    {
+      return;
+    }
+  if (n <= chunk)
+    {
+      scan_first_chunk<T> (src, dst, 0, n, op);
+      return;
+    }
+  // the total of every chunk, then the total of everything before it.
+  vl_vector<T, 0> offsets ((n + chunk - 1) / chunk);
+  run_chunks (n, [src, &offsets, &op] (size_t i, size_t first, size_t last) {
+    T sum = src[first];
+    for (size_t j = first + 1; j < last; ++j)
+      {
+        sum = op (sum, src[j]);
+      }
+    offsets[i] = sum;
+  });
+  for (size_t i = 1; i < offsets.size (); ++i)
+    {
+      offsets[i] = op (offsets[i - 1], offsets[i]);
+    }
+  run_chunks (n, [src, dst, &offsets, &op] (size_t i, size_t first,
+                                            size_t last) {
+    if (i == 0)
+      {
+        scan_first_chunk<T> (src, dst, first, last, op);
+      }
+    else
+      {
+        std::inclusive_scan (src + first, src + last, dst + first, op,
+                             offsets[i - 1]);
+      }
+  });
+}
+
+/**
+ * Sorts the vector: every chunk is sorted on its own, and then sorted runs
+ * are merged in pairs, in parallel, until one run is left.
+ * @param v A vector.
+ * @param comp A comparison, std::less by default.
+ */
+template<typename Vector, typename Compare = std::less<>>
+void sort (Vector &v, Compare comp = Compare ()) noexcept (false)
+{
+  using T = typename Vector::value_type;
+  T *data = v.data ();
+  const size_t n = v.size ();
+  const size_t chunk = chunk_size (n);
+  if (n <= chunk)
+    {
+      std::sort (data, data + n, comp);
+      return;
+    }
+  run_chunks (n, [data, &comp] (size_t, size_t first, size_t last) {
+    std::sort (data + first, data + last, comp);
+  });
+  vl_vector<T, 0> buffer (n);
+  T *src = data;
+  T *dst = buffer.data ();
+  for (size_t width = chunk; width < n; width *= 2)
+    {
+      const size_t pairs = (n + 2 * width - 1) / (2 * width);
+      run_tasks (pairs, [src, dst, width, n, &comp] (size_t i) {
+        const size_t first = 2 * width * i;
+        const size_t middle = std::min (n, first + width);
+        const size_t last = std::min (n, first + 2 * width);
+        std::merge (src + first, src + middle, src + middle, src + last,
+                    dst + first, comp);
+      });
+      std::swap (src, dst);
+    }
+  if (src != data)
+    {
+      run_chunks (n, [src, data] (size_t, size_t first, size_t last) {
+        std::copy (src + first, src + last, data + first);
+      });
+    }
+}
+
+}
+
+#endif //_VL_PARALLEL_H_
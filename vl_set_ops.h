@@ -0,0 +1,573 @@
+#ifndef _VL_SET_OPS_H_
+#define _VL_SET_OPS_H_
+
+#include "vl_sort.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// when one set is this many times larger, the smaller one gallops over it.
+#ifndef GALLOP_RATIO
+#define GALLOP_RATIO 32
+#endif
+#define SET_BLOCK 4 // 32-bit elements compared at once.
+// 1 to merge unions of similar sizes with an SSE2 merge network. It's off
+// by default, since bench/bench_vl_set_ops.cpp finds the branchless scalar
+// merge as fast or faster: SSE2 has no 32-bit min and max.
+#ifndef SET_SIMD_UNION
+#define SET_SIMD_UNION 0
+#endif
+#define SET_OUTPUT_BUFFER 256
+
+/**
+ * Collects the output of a set operation in a small buffer, and appends it
+ * to the destination vector a buffer at a time, since vectors only grow by
+ * insertion.
+ * @tparam Vector The type of the destination vector.
+ */
+template<typename Vector>
+class vl_set_output {
+ private:
+  /************* Private Fields **************/
+  using T = typename Vector::value_type;
+  Vector &_dst; // the vector to append to.
+  T _buffer[SET_OUTPUT_BUFFER]; // elements that weren't appended yet.
+  size_t _count; // number of elements in the buffer.
+
+ public:
+  /************* Constructor **************/
+
+  /**
+   * Prepares to append to dst, and reserves room for at most bound more
+   * elements once.
+   * @param dst The vector to append to.
+   * @param bound The largest number of elements the operation can output.
+   */
+  vl_set_output (Vector &dst, const size_t bound) : _dst (dst), _count (0)
+  {
+    _dst.reserve (_dst.size () + bound);
+  }
+
+  vl_set_output (const vl_set_output &) = delete;
+
+  /************* Public Methods **************/
+
+  /**
+   * Appends an element.
+   * @param element An element to append.
+   */
+  void push (const T &element) noexcept (false)
+  {
+    _buffer[_count++] = element;
+    if (_count == SET_OUTPUT_BUFFER)
+      {
+        flush ();
+      }
+  }
+
+  /**
+   * Appends the elements of a block of SET_BLOCK, but those whose bits are
+   * set in skip, without branching on them.
+   * @param block A pointer to the block.
+   * @param skip A mask with bit l set if element l isn't appended.
+   */
+  void push_block (const T *block, const int skip) noexcept (false)
+  {
+    for (int l = 0; l < SET_BLOCK; ++l)
+      {
+        _buffer[_count] = block[l];
+        _count += !(skip & (1 << l));
+      }
+    if (_count > SET_OUTPUT_BUFFER - SET_BLOCK)
+      {
+        flush ();
+      }
+  }
+
+  /**
+   * Appends the elements of the range [first, last) right away.
+   * @param first A pointer to the first element.
+   * @param last A pointer past the last element.
+   */
+  void push (const T *first, const T *last) noexcept (false)
+  {
+    flush ();
+    _dst.insert (_dst.end (), first, last);
+  }
+
+  /**
+   * Appends the elements in the buffer to the vector. Must be called when
+   * the operation is done.
+   */
+  void flush () noexcept (false)
+  {
+    _dst.insert (_dst.end (), _buffer, _buffer + _count);
+    _count = 0;
+  }
+};
+
+/**
+ * Checks if an input of a set operation is in the destination vector, whose
+ * reserve may free it while the operation still reads it.
+ * @tparam A A contiguous container with data () and size ().
+ * @tparam Vector A vector of the same elements.
+ * @param a An input.
+ * @param dst The destination vector.
+ * @return true if a has elements in dst, otherwise false.
+ */
+template<class A, class Vector>
+bool vl_set_aliases (const A &a, const Vector &dst) noexcept (true)
+{
+  using T = typename Vector::value_type;
+  const std::less<const T *> less;
+  return a.size () != 0 && !less (a.data (), dst.data ())
+         && less (a.data (), dst.data () + dst.size ());
+}
+
+/**
+ * true for the types whose set operations compare SET_BLOCK elements at
+ * once with SSE2: 32-bit integers.
+ * @tparam T The type of the elements.
+ */
+template<typename T>
+constexpr bool vl_is_set_simd =
+#ifdef __SSE2__
+    std::is_integral<T>::value && sizeof (T) == 4;
+#else
+    false;
+#endif
+
+/**
+ * Searches a sorted range from a position onwards, by doubling the step
+ * until it passes value, then searching the last step without branches.
+ * Takes O(log d) comparisons, where d is how far the result is.
+ * @tparam T The type of the elements.
+ * @param data A pointer to n elements in ascending order.
+ * @param n Number of elements.
+ * @param from Where to start, which must not be after the result.
+ * @param value A value to search for.
+ * @return The index of the first element that isn't less than value, or n
+ *         if there is none.
+ */
+template<typename T>
+size_t vl_gallop (const T *data, const size_t n, size_t from, const T &value)
+noexcept (false)
+{
+  size_t step = 1;
+  size_t to = from;
+  while (to < n && data[to] < value)
+    {
+      from = to + 1;
+      to += step;
+      step *= 2;
+    }
+  to = std::min (to, n);
+  return vl_branchless_lower_bound (data + from, to - from, value) - data;
+}
+
+#ifdef __SSE2__
+/**
+ * Compares a block of SET_BLOCK elements of a with a block of b, every
+ * element against every element, by comparing a with all the rotations of
+ * b.
+ * @param a A pointer to the block of a.
+ * @param b A pointer to the block of b.
+ * @return A mask with bit l set if element l of a is in the block of b.
+ */
+template<typename T>
+int vl_block_matches (const T *a, const T *b) noexcept (true)
+{
+  const __m128i va = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (a));
+  const __m128i vb = _mm_loadu_si128 (reinterpret_cast<const __m128i *> (b));
+  __m128i eq = _mm_cmpeq_epi32 (va, vb);
+  eq = _mm_or_si128 (eq, _mm_cmpeq_epi32 (
+      va, _mm_shuffle_epi32 (vb, _MM_SHUFFLE (0, 3, 2, 1))));
+  eq = _mm_or_si128 (eq, _mm_cmpeq_epi32 (
+      va, _mm_shuffle_epi32 (vb, _MM_SHUFFLE (1, 0, 3, 2))));
+  eq = _mm_or_si128 (eq, _mm_cmpeq_epi32 (
+      va, _mm_shuffle_epi32 (vb, _MM_SHUFFLE (2, 1, 0, 3))));
+  return _mm_movemask_ps (_mm_castsi128_ps (eq));
+}
+
+/**
+ * @param a A block of signed 32-bit integers.
+ * @param b Another block.
+ * @return The smaller element of every lane.
+ */
+inline __m128i vl_block_min (const __m128i a, const __m128i b) noexcept (true)
+{
+  const __m128i gt = _mm_cmpgt_epi32 (a, b);
+  return _mm_or_si128 (_mm_and_si128 (gt, b), _mm_andnot_si128 (gt, a));
+}
+
+/**
+ * @param a A block of signed 32-bit integers.
+ * @param b Another block.
+ * @return The larger element of every lane.
+ */
+inline __m128i vl_block_max (const __m128i a, const __m128i b) noexcept (true)
+{
+  const __m128i gt = _mm_cmpgt_epi32 (a, b);
+  return _mm_or_si128 (_mm_and_si128 (gt, a), _mm_andnot_si128 (gt, b));
+}
+
+/**
+ * Sorts a bitonic block, which rises and then falls, with the two steps of
+ * a bitonic merge.
+ * @param x A bitonic block of signed 32-bit integers.
+ * @return The block in ascending order.
+ */
+inline __m128i vl_block_bitonic_sort (__m128i x) noexcept (true)
+{
+  __m128i y = _mm_shuffle_epi32 (x, _MM_SHUFFLE (1, 0, 3, 2));
+  x = _mm_unpacklo_epi64 (vl_block_min (x, y), vl_block_max (x, y));
+  y = _mm_shuffle_epi32 (x, _MM_SHUFFLE (2, 3, 0, 1));
+  const __m128i even = _mm_set_epi32 (0, -1, 0, -1);
+  return _mm_or_si128 (_mm_and_si128 (even, vl_block_min (x, y)),
+                       _mm_andnot_si128 (even, vl_block_max (x, y)));
+}
+
+/**
+ * Merges two ascending blocks into the lowest and the highest SET_BLOCK of
+ * their elements, with a bitonic merge network.
+ * @param lo An ascending block of signed 32-bit integers, which gets the
+ *           lowest elements.
+ * @param hi Another ascending block, which gets the highest elements.
+ */
+inline void vl_block_merge (__m128i &lo, __m128i &hi) noexcept (true)
+{
+  const __m128i reversed = _mm_shuffle_epi32 (hi, _MM_SHUFFLE (0, 1, 2, 3));
+  const __m128i low = vl_block_min (lo, reversed);
+  hi = vl_block_bitonic_sort (vl_block_max (lo, reversed));
+  lo = vl_block_bitonic_sort (low);
+}
+#endif
+
+/**
+ * Appends to dst the elements that are in both a and b, in ascending
+ * order. a and b must be sorted sets, without duplicates. When one is
+ * GALLOP_RATIO times larger than the other, every element of the smaller
+ * one is galloped for in the larger one; otherwise 32-bit integers are
+ * compared SET_BLOCK by SET_BLOCK with SSE2, and other types are merged.
+ * @tparam A A contiguous container with data () and size ().
+ * @tparam B A contiguous container of the same elements.
+ * @tparam Vector A vector of the same elements, like vl_vector.
+ * @param a A sorted set.
+ * @param b Another sorted set.
+ * @param dst The vector to append the intersection to, which may be a or b.
+ */
+template<class A, class B, class Vector>
+void vl_set_intersect (const A &a, const B &b, Vector &dst) noexcept (false)
+{
+  using T = typename Vector::value_type;
+  if (vl_set_aliases (a, dst) || vl_set_aliases (b, dst))
+    {
+      Vector result;
+      vl_set_intersect (a, b, result);
+      dst.insert (dst.end (), result.begin (), result.end ());
+      return;
+    }
+  const T *small = a.data ();
+  const T *large = b.data ();
+  size_t small_n = a.size ();
+  size_t large_n = b.size ();
+  if (small_n > large_n)
+    {
+      std::swap (small, large);
+      std::swap (small_n, large_n);
+    }
+  vl_set_output<Vector> out (dst, small_n);
+  size_t i = 0;
+  size_t j = 0;
+  if (small_n * GALLOP_RATIO <= large_n)
+    {
+      for (; i < small_n && j < large_n; ++i)
+        {
+          j = vl_gallop (large, large_n, j, small[i]);
+          if (j < large_n && !(small[i] < large[j]))
+            {
+              out.push (small[i]);
+            }
+        }
+      out.flush ();
+      return;
+    }
+#ifdef __SSE2__
+  if constexpr (vl_is_set_simd<T>)
+    {
+      while (i + SET_BLOCK <= small_n && j + SET_BLOCK <= large_n)
+        {
+          int matches = vl_block_matches (small + i, large + j);
+          for (; matches != 0; matches &= matches - 1)
+            {
+              out.push (small[i + __builtin_ctz (matches)]);
+            }
+          const T small_max = small[i + SET_BLOCK - 1];
+          const T large_max = large[j + SET_BLOCK - 1];
+          i += (small_max <= large_max) ? SET_BLOCK : 0;
+          j += (large_max <= small_max) ? SET_BLOCK : 0;
+        }
+    }
+#endif
+  while (i < small_n && j < large_n)
+    {
+      const T x = small[i];
+      const T y = large[j];
+      if (x == y)
+        {
+          out.push (x);
+        }
+      i += !(y < x);
+      j += !(x < y);
+    }
+  out.flush ();
+}
+
+/**
+ * Appends to dst the elements that are in a or in b, in ascending order.
+ * a and b must be sorted sets, without duplicates. When one is GALLOP_RATIO
+ * times larger than the other, every element of the smaller one is
+ * galloped for in the larger one, and the runs of the larger one between
+ * them are appended at once; otherwise they are merged without branches,
+ * or with SET_SIMD_UNION, 32-bit integers are merged SET_BLOCK by SET_BLOCK
+ * with an SSE2 merge network.
+ * @tparam A A contiguous container with data () and size ().
+ * @tparam B A contiguous container of the same elements.
+ * @tparam Vector A vector of the same elements, like vl_vector.
+ * @param a A sorted set.
+ * @param b Another sorted set.
+ * @param dst The vector to append the union to, which may be a or b.
+ */
+template<class A, class B, class Vector>
+void vl_set_union (const A &a, const B &b, Vector &dst) noexcept (false)
+{
+  using T = typename Vector::value_type;
+  if (vl_set_aliases (a, dst) || vl_set_aliases (b, dst))
+    {
+      Vector result;
+      vl_set_union (a, b, result);
+      dst.insert (dst.end (), result.begin (), result.end ());
+      return;
+    }
+  const T *small = a.data ();
+  const T *large = b.data ();
+  size_t small_n = a.size ();
+  size_t large_n = b.size ();
+  if (small_n > large_n)
+    {
+      std::swap (small, large);
+      std::swap (small_n, large_n);
+    }
+  vl_set_output<Vector> out (dst, small_n + large_n);
+  size_t i = 0;
+  size_t j = 0;
+  if (small_n * GALLOP_RATIO <= large_n)
+    {
+      for (; i < small_n; ++i)
+        {
+          const size_t next = vl_gallop (large, large_n, j, small[i]);
+          out.push (large + j, large + next);
+          out.push (small[i]);
+          j = (next < large_n && !(small[i] < large[next])) ? next + 1 : next;
+        }
+      out.push (large + j, large + large_n);
+      return;
+    }
+#ifdef __SSE2__
+  if constexpr (vl_is_set_simd<T> && SET_SIMD_UNION)
+    {
+      if (i + SET_BLOCK <= small_n && j + SET_BLOCK <= large_n)
+        {
+          // unsigned elements are biased to compare as signed ones.
+          const __m128i bias =
+              _mm_set1_epi32 (std::is_signed<T>::value ? 0 : INT32_MIN);
+          const auto load = [&bias] (const T *block) {
+            return _mm_xor_si128 (bias, _mm_loadu_si128 (
+                reinterpret_cast<const __m128i *> (block)));
+          };
+          __m128i lo = load (small + i);
+          __m128i hi = load (large + j);
+          // the last lane of the first block of small is above the lowest
+          // element, so the first one is never taken for a repeat.
+          __m128i previous = lo;
+          i += SET_BLOCK;
+          j += SET_BLOCK;
+          T block[SET_BLOCK];
+          while (true)
+            {
+              // merges the next block into the highest elements so far,
+              // and appends the lowest ones, but those that repeat the
+              // element before them.
+              vl_block_merge (lo, hi);
+              const int duplicates = _mm_movemask_ps (_mm_castsi128_ps (
+                  _mm_cmpeq_epi32 (lo, _mm_or_si128 (
+                      _mm_slli_si128 (lo, 4),
+                      _mm_srli_si128 (previous, 12)))));
+              previous = lo;
+              _mm_storeu_si128 (reinterpret_cast<__m128i *> (block),
+                                _mm_xor_si128 (bias, lo));
+              out.push_block (block, duplicates);
+              if (i + SET_BLOCK > small_n || j + SET_BLOCK > large_n)
+                {
+                  break;
+                }
+              // the next block is from the set whose next element is
+              // smaller, so no element that's left is below the ones that
+              // were appended.
+              const size_t from_small = small[i] < large[j];
+              const __m128i take = _mm_set1_epi32 (-(int) from_small);
+              lo = _mm_or_si128 (_mm_and_si128 (take, load (small + i)),
+                                 _mm_andnot_si128 (take, load (large + j)));
+              i += from_small * SET_BLOCK;
+              j += (1 - from_small) * SET_BLOCK;
+            }
+          // the highest elements weren't appended, so they're merged again
+          // from the sets, without the last element that was appended.
+          const T last = block[SET_BLOCK - 1];
+          while (i > 0 && last < small[i - 1])
+            {
+              --i;
+            }
+          while (j > 0 && last < large[j - 1])
+            {
+              --j;
+            }
+          i += (i < small_n && small[i] == last);
+          j += (j < large_n && large[j] == last);
+        }
+    }
+#endif
+  while (i < small_n && j < large_n)
+    {
+      const T x = small[i];
+      const T y = large[j];
+      out.push ((y < x) ? y : x);
+      i += !(y < x);
+      j += !(x < y);
+    }
+  out.push (small + i, small + small_n);
+  out.push (large + j, large + large_n);
+}
+
+/**
+ * Appends to dst the elements of a that aren't in b, in ascending order.
+ * a and b must be sorted sets, without duplicates. When a is GALLOP_RATIO
+ * times smaller than b, every element of a is galloped for in b; when b is
+ * GALLOP_RATIO times smaller, every element of b is galloped for in a, and
+ * the runs of a between them are appended at once. Otherwise 32-bit
+ * integers are compared SET_BLOCK by SET_BLOCK with SSE2, and other types
+ * are merged.
+ * @tparam A A contiguous container with data () and size ().
+ * @tparam B A contiguous container of the same elements.
+ * @tparam Vector A vector of the same elements, like vl_vector.
+ * @param a A sorted set.
+ * @param b The sorted set to remove from a.
+ * @param dst The vector to append the difference to, which may be a or b.
+ */
+template<class A, class B, class Vector>
+void vl_set_difference (const A &a, const B &b, Vector &dst) noexcept (false)
+{
+  using T = typename Vector::value_type;
+  if (vl_set_aliases (a, dst) || vl_set_aliases (b, dst))
+    {
+      Vector result;
+      vl_set_difference (a, b, result);
+      dst.insert (dst.end (), result.begin (), result.end ());
+      return;
+    }
+  const T *pa = a.data ();
+  const T *pb = b.data ();
+  const size_t na = a.size ();
+  const size_t nb = b.size ();
+  vl_set_output<Vector> out (dst, na);
+  size_t i = 0;
+  size_t j = 0;
+  if (na * GALLOP_RATIO <= nb)
+    {
+      for (; i < na; ++i)
+        {
+          j = vl_gallop (pb, nb, j, pa[i]);
+          if (j == nb || pa[i] < pb[j])
+            {
+              out.push (pa[i]);
+            }
+        }
+      out.flush ();
+      return;
+    }
+  if (nb * GALLOP_RATIO <= na)
+    {
+      for (; j < nb; ++j)
+        {
+          const size_t next = vl_gallop (pa, na, i, pb[j]);
+          out.push (pa + i, pa + next);
+          i = (next < na && !(pb[j] < pa[next])) ? next + 1 : next;
+        }
+      out.push (pa + i, pa + na);
+      return;
+    }
+#ifdef __SSE2__
+  if constexpr (vl_is_set_simd<T>)
+    {
+      // lanes of the current block of a found in the blocks of b so far.
+      int found = 0;
+      while (i + SET_BLOCK <= na && j + SET_BLOCK <= nb)
+        {
+          found |= vl_block_matches (pa + i, pb + j);
+          const T a_max = pa[i + SET_BLOCK - 1];
+          const T b_max = pb[j + SET_BLOCK - 1];
+          if (a_max <= b_max)
+            {
+              for (int missing = ~found & ((1 << SET_BLOCK) - 1);
+                   missing != 0; missing &= missing - 1)
+                {
+                  out.push (pa[i + __builtin_ctz (missing)]);
+                }
+              found = 0;
+              i += SET_BLOCK;
+            }
+          j += (b_max <= a_max) ? SET_BLOCK : 0;
+        }
+      if (found != 0)
+        {
+          // the block of a was partly found, so its other lanes are merged
+          // on their own with the rest of b.
+          const size_t block_end = i + SET_BLOCK;
+          for (; i < block_end; ++i)
+            {
+              if (found & (1 << (SET_BLOCK - (block_end - i))))
+                {
+                  continue;
+                }
+              while (j < nb && pb[j] < pa[i])
+                {
+                  ++j;
+                }
+              if (j == nb || pa[i] < pb[j])
+                {
+                  out.push (pa[i]);
+                }
+            }
+        }
+    }
+#endif
+  while (i < na && j < nb)
+    {
+      const T x = pa[i];
+      const T y = pb[j];
+      if (x < y)
+        {
+          out.push (x);
+        }
+      i += !(y < x);
+      j += !(x < y);
+    }
+  out.push (pa + i, pa + na);
+}
+
+#endif //_VL_SET_OPS_H_
@@ -0,0 +1,858 @@
+#ifndef _VL_SOA_VECTOR_H_
+#define _VL_SOA_VECTOR_H_
+
+#include "vl_vector.h"
+#include <iterator>
+#include <tuple>
+#include <utility>
+
+/**
+ * Represents a Variable Length Vector of rows with the fields Ts..., stored
+ * as a struct of arrays: every field has a column of its own, and all the
+ * columns share a single size and capacity. A loop that reads only one or
+ * two fields streams through only their columns, instead of pulling whole
+ * rows into the cache, and every column is a contiguous array of one type
+ * that can be vectorized. Like vl_vector, the columns are on the stack
+ * (static memory) as long as the size is at most StaticCapacity, and on the
+ * heap (dynamic memory) beyond that.
+ * @tparam StaticCapacity How much rows can be on the stack.
+ * @tparam Ts The types of the fields of a row.
+ */
+template<const size_t StaticCapacity, typename... Ts>
+class vl_basic_soa_vector {
+  static_assert (sizeof... (Ts) > 0, "A row must have at least one field");
+  static_assert (StaticCapacity > 0, "StaticCapacity must be positive");
+
+ public:
+  /**
+   * The type of field I.
+   * @tparam I The index of a field.
+   */
+  template<const size_t I>
+  using field_type = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+  using value_type = std::tuple<Ts...>;
+
+ private:
+  using fields = std::index_sequence_for<Ts...>;
+
+  /**
+   * The stack memory of the column of a field.
+   * @tparam T The type of the field.
+   */
+  template<typename T>
+  struct stack_column {
+    T data[StaticCapacity]; // holds the column in the stack memory.
+  };
+
+  /************* Private Fields **************/
+  std::tuple<stack_column<Ts>...> _stack; // the columns on the stack.
+  std::tuple<Ts *...> _heap; // the columns on the heap, or nullptr.
+  size_t _size; // number of rows.
+  size_t _cap; // capacity of every column.
+
+  /************* Private Methods **************/
+
+  /**
+   * The capacity function of vl_vector: the columns stay on the stack while
+   * they fit there, and otherwise grow by GROWTH_FACTOR.
+   * @param size Number of rows the vector contains.
+   * @param k Number of rows we want to add to the vector.
+   * @return The capacity the vector should have.
+   */
+  static size_t cap_c (const size_t &size, const size_t &k) noexcept (false)
+  {
+    return (size + k <= StaticCapacity) ?
+           StaticCapacity : vl_grow_capacity (size, k, max_size ());
+  }
+
+  /**
+   * Moves all the rows to columns with the capacity new_cap, on the stack
+   * if it's StaticCapacity, and frees the old heap columns.
+   * @param new_cap The new capacity, at least the size.
+   */
+  template<const size_t... I>
+  void relocate (const size_t new_cap, std::index_sequence<I...>)
+  noexcept (false)
+  {
+    std::tuple<Ts *...> heap{};
+    if (new_cap != StaticCapacity)
+      {
+        try
+          {
+            ((std::get<I> (heap) = vl_allocate<field_type<I>> (
+                new_cap, alignof (field_type<I>))), ...);
+          }
+        catch (...)
+          {
+            (vl_deallocate (std::get<I> (heap), new_cap,
+                            alignof (field_type<I>)), ...);
+            throw;
+          }
+      }
+    ((std::move (data<I> (), data<I> () + _size,
+                 (new_cap == StaticCapacity) ?
+                 std::get<I> (_stack).data : std::get<I> (heap))), ...);
+    free_heap (fields ());
+    _heap = heap;
+    _cap = new_cap;
+  }
+
+  /**
+   * Frees the heap columns, if there are any.
+   */
+  template<const size_t... I>
+  void free_heap (std::index_sequence<I...>) noexcept (true)
+  {
+    (vl_deallocate (std::get<I> (_heap), _cap, alignof (field_type<I>)), ...);
+    _heap = std::tuple<Ts *...>{};
+  }
+
+  /**
+   * Makes room for k more rows, growing like vl_vector.
+   * @param k Number of rows we want to add.
+   */
+  void grow (const size_t k) noexcept (false)
+  {
+    if (_size + k > _cap)
+      {
+        relocate (cap_c (_size, k), fields ());
+      }
+  }
+
+  /**
+   * Moves rows [index, size) k rows to the right, in every column.
+   */
+  template<const size_t... I>
+  void shift_right (const size_t index, const size_t k,
+                    std::index_sequence<I...>) noexcept (false)
+  {
+    (std::move_backward (data<I> () + index, data<I> () + _size,
+                         data<I> () + _size + k), ...);
+  }
+
+  /**
+   * Moves rows [last, size) to first, in every column.
+   */
+  template<const size_t... I>
+  void shift_left (const size_t first, const size_t last,
+                   std::index_sequence<I...>) noexcept (false)
+  {
+    (std::move (data<I> () + last, data<I> () + _size, data<I> () + first),
+        ...);
+  }
+
+  /**
+   * Assigns a row.
+   * @param i The index of the row.
+   * @param values The fields of the row.
+   */
+  template<const size_t... I>
+  void assign_row (const size_t i, std::index_sequence<I...>,
+                   const Ts &... values) noexcept (false)
+  {
+    ((data<I> ()[i] = values), ...);
+  }
+
+  /**
+   * Copies all the rows of rhs to this, which must be empty.
+   * @param rhs Another vector.
+   */
+  template<const size_t... I>
+  void copy_from (const vl_basic_soa_vector &rhs, std::index_sequence<I...>)
+  noexcept (false)
+  {
+    grow (rhs._size);
+    (vl_bulk_copy (rhs.data<I> (), rhs.data<I> () + rhs._size, data<I> ()),
+        ...);
+    _size = rhs._size;
+  }
+
+  /**
+   * Steals the heap columns of rhs if it has them, otherwise moves its
+   * rows. This must be empty, and rhs is left empty.
+   * @param rhs Another vector.
+   */
+  template<const size_t... I>
+  void move_from (vl_basic_soa_vector &rhs, std::index_sequence<I...>)
+  noexcept (true)
+  {
+    if (rhs._cap != StaticCapacity)
+      {
+        _heap = rhs._heap;
+        _cap = rhs._cap;
+        rhs._heap = std::tuple<Ts *...>{};
+        rhs._cap = StaticCapacity;
+      }
+    else
+      {
+        (std::move (rhs.data<I> (), rhs.data<I> () + rhs._size, data<I> ()),
+            ...);
+      }
+    _size = rhs._size;
+    rhs._size = 0;
+  }
+
+  /**
+   * @return true if the rows of this and rhs are equal, in the same order.
+   */
+  template<const size_t... I>
+  bool equal (const vl_basic_soa_vector &rhs, std::index_sequence<I...>)
+  const noexcept (false)
+  {
+    return _size == rhs._size
+           && (std::equal (data<I> (), data<I> () + _size, rhs.data<I> ())
+               && ...);
+  }
+
+ public:
+  /************* Row Reference **************/
+
+  /**
+   * A proxy to a row, made of references to its fields in their columns.
+   * Assigning to it assigns the fields, and it converts to a value_type.
+   * @tparam Fs The fields, Ts... or const Ts... for a const row.
+   */
+  template<typename... Fs>
+  class row_ref {
+   private:
+    std::tuple<Fs &...> _fields; // the fields of the row.
+
+   public:
+    /**
+     * Constructs a proxy to the row with the given fields.
+     * @param fields The fields of the row.
+     */
+    explicit row_ref (Fs &... fields) : _fields (fields...)
+    {}
+
+    row_ref (const row_ref &) = default;
+
+    /**
+     * @tparam I The index of a field.
+     * @return A reference to field I of the row.
+     */
+    template<const size_t I>
+    auto &get () const noexcept (true)
+    {
+      return std::get<I> (_fields);
+    }
+
+    /**
+     * Assigns the fields of a row to the fields of this row.
+     * @param row A row.
+     * @return this.
+     */
+    row_ref &operator= (const value_type &row) noexcept (false)
+    {
+      _fields = row;
+      return *this;
+    }
+
+    /**
+     * Assigns the fields of another row to the fields of this row.
+     * @param rhs A proxy to another row.
+     * @return this.
+     */
+    row_ref &operator= (const row_ref &rhs) noexcept (false)
+    {
+      _fields = value_type (rhs);
+      return *this;
+    }
+
+    /**
+     * @return a copy of the row.
+     */
+    operator value_type () const noexcept (false)
+    {
+      return value_type (_fields);
+    }
+  };
+
+  using reference = row_ref<Ts...>;
+  using const_reference = row_ref<const Ts...>;
+
+  /************* Iterator and Const Iterator **************/
+
+  /**
+   * A random access iterator over the rows, that dereferences to proxies.
+   * @tparam Vector The vector, or the const vector for a const iterator.
+   * @tparam Ref The proxy of a row.
+   */
+  template<typename Vector, typename Ref>
+  class basic_iterator {
+   private:
+    Vector *_vector; // the vector.
+    size_t _index; // the index of the current row.
+
+   public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::tuple<Ts...>;
+    using difference_type = std::ptrdiff_t;
+    using reference = Ref;
+    using pointer = void;
+
+    /**
+     * Constructs an iterator to a row.
+     * @param vector The vector.
+     * @param index The index of the row.
+     */
+    basic_iterator (Vector *vector, const size_t index) :
+        _vector (vector), _index (index)
+    {}
+
+    /**
+     * Converts an iterator to a const iterator.
+     * @param it An iterator.
+     */
+    template<typename U, typename R, typename = typename std::enable_if<
+        std::is_same<const U, Vector>::value
+        && !std::is_same<U, Vector>::value>::type>
+    basic_iterator (const basic_iterator<U, R> &it) :
+        _vector (it.vector ()), _index (it.index ())
+    {}
+
+    /**
+     * @return the vector.
+     */
+    Vector *vector () const noexcept (true)
+    {
+      return _vector;
+    }
+
+    /**
+     * @return the index of the current row.
+     */
+    size_t index () const noexcept (true)
+    {
+      return _index;
+    }
+
+    reference operator* () const noexcept (true)
+    {
+      return (*_vector)[_index];
+    }
+
+    reference operator[] (const difference_type n) const noexcept (true)
+    {
+      return (*_vector)[_index + n];
+    }
+
+    basic_iterator &operator++ () noexcept (true)
+    {
+      ++_index;
+      return *this;
+    }
+
+    basic_iterator operator++ (int) noexcept (true)
+    {
+      basic_iterator it = *this;
+      ++_index;
+      return it;
+    }
+
+    basic_iterator &operator-- () noexcept (true)
+    {
+      --_index;
+      return *this;
+    }
+
+    basic_iterator operator-- (int) noexcept (true)
+    {
+      basic_iterator it = *this;
+      --_index;
+      return it;
+    }
+
+    basic_iterator &operator+= (const difference_type n) noexcept (true)
+    {
+      _index += n;
+      return *this;
+    }
+
+    basic_iterator &operator-= (const difference_type n) noexcept (true)
+    {
+      _index -= n;
+      return *this;
+    }
+
+    basic_iterator operator+ (const difference_type n) const noexcept (true)
+    {
+      return basic_iterator (_vector, _index + n);
+    }
+
+    friend basic_iterator operator+ (const difference_type n,
+                                     const basic_iterator &it)
+    noexcept (true)
+    {
+      return it + n;
+    }
+
+    basic_iterator operator- (const difference_type n) const noexcept (true)
+    {
+      return basic_iterator (_vector, _index - n);
+    }
+
+    difference_type operator- (const basic_iterator &rhs) const
+    noexcept (true)
+    {
+      return (difference_type) _index - (difference_type) rhs._index;
+    }
+
+    bool operator== (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _index == rhs._index;
+    }
+
+    bool operator!= (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _index != rhs._index;
+    }
+
+    bool operator< (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _index < rhs._index;
+    }
+
+    bool operator> (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _index > rhs._index;
+    }
+
+    bool operator<= (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _index <= rhs._index;
+    }
+
+    bool operator>= (const basic_iterator &rhs) const noexcept (true)
+    {
+      return _index >= rhs._index;
+    }
+  };
+
+  using iterator = basic_iterator<vl_basic_soa_vector, reference>;
+  using const_iterator =
+      basic_iterator<const vl_basic_soa_vector, const_reference>;
+
+  /************* Constructors & Destructor **************/
+
+  /**
+   * Default constructor which initializes an empty vector on the stack.
+   */
+  vl_basic_soa_vector () : _heap{}, _size (0), _cap (StaticCapacity)
+  {}
+
+  /**
+   * Copy Constructor.
+   * @param rhs A vector to copy from.
+   */
+  vl_basic_soa_vector (const vl_basic_soa_vector &rhs) :
+      vl_basic_soa_vector ()
+  {
+    copy_from (rhs, fields ());
+  }
+
+  /**
+   * Move Constructor. Steals the heap columns of rhs if it has them, and
+   * leaves rhs empty.
+   * @param rhs A vector to move from.
+   */
+  vl_basic_soa_vector (vl_basic_soa_vector &&rhs) noexcept (true) :
+      vl_basic_soa_vector ()
+  {
+    move_from (rhs, fields ());
+  }
+
+  /**
+   * Initializes the vector with 'count' rows of value initialized fields.
+   * @param count Number of rows.
+   */
+  explicit vl_basic_soa_vector (const size_t &count) : vl_basic_soa_vector ()
+  {
+    resize (count);
+  }
+
+  /**
+   * Destructor.
+   */
+  ~vl_basic_soa_vector ()
+  {
+    free_heap (fields ());
+  }
+
+  /**
+   * @return an iterator to the first row.
+   */
+  iterator begin () noexcept (true)
+  {
+    return iterator (this, 0);
+  }
+
+  /**
+   * @return an iterator past the last row.
+   */
+  iterator end () noexcept (true)
+  {
+    return iterator (this, _size);
+  }
+
+  /**
+   * @return a const iterator to the first row.
+   */
+  const_iterator begin () const noexcept (true)
+  {
+    return const_iterator (this, 0);
+  }
+
+  /**
+   * @return a const iterator past the last row.
+   */
+  const_iterator end () const noexcept (true)
+  {
+    return const_iterator (this, _size);
+  }
+
+  /************* Public Methods **************/
+
+  /**
+   * @tparam I The index of a field.
+   * @return a pointer to the column of field I (on the stack or on the
+   *         heap).
+   */
+  template<const size_t I>
+  field_type<I> *data () noexcept (true)
+  {
+    return (_cap == StaticCapacity) ?
+           std::get<I> (_stack).data : std::get<I> (_heap);
+  }
+
+  /**
+   * @tparam I The index of a field.
+   * @return a const pointer to the column of field I (on the stack or on
+   *         the heap).
+   */
+  template<const size_t I>
+  const field_type<I> *data () const noexcept (true)
+  {
+    return (_cap == StaticCapacity) ?
+           std::get<I> (_stack).data : std::get<I> (_heap);
+  }
+
+#if __cplusplus >= 202002L
+  /**
+   * @tparam I The index of a field.
+   * @return a span over the column of field I.
+   */
+  template<const size_t I>
+  std::span<field_type<I>> column () noexcept (true)
+  {
+    return std::span<field_type<I>> (data<I> (), _size);
+  }
+
+  /**
+   * @tparam I The index of a field.
+   * @return a span over the column of field I.
+   */
+  template<const size_t I>
+  std::span<const field_type<I>> column () const noexcept (true)
+  {
+    return std::span<const field_type<I>> (data<I> (), _size);
+  }
+#endif
+
+  /**
+   * @return the current amount of rows in the vector.
+   */
+  size_t size () const noexcept (true)
+  {
+    return _size;
+  }
+
+  /**
+   * @return the capacity of the vector.
+   */
+  size_t capacity () const noexcept (true)
+  {
+    return _cap;
+  }
+
+  /**
+   * @return the maximal amount of rows the vector can hold, which is
+   *         bounded by its largest field.
+   */
+  static constexpr size_t max_size () noexcept (true)
+  {
+    return std::min ({vl_max_size<Ts> ()...});
+  }
+
+  /**
+   * @return true if the vector is empty, otherwise false.
+   */
+  bool empty () const noexcept (true)
+  {
+    return _size == 0;
+  }
+
+  /**
+   * Makes sure the vector can hold at least n rows without another
+   * allocation. Does nothing if the capacity is already large enough.
+   * @param n The requested capacity.
+   */
+  void reserve (const size_t n) noexcept (false)
+  {
+    if (n <= _cap)
+      {
+        return;
+      }
+    if (n > max_size ())
+      {
+        throw std::length_error{"Capacity exceeds max_size"};
+      }
+    relocate (n, fields ());
+  }
+
+  /**
+   * @param i An index.
+   * @return A proxy to the row at index i.
+   */
+  reference at (const size_t &i) noexcept (false)
+  {
+    if (i >= _size)
+      {
+        throw std::out_of_range{"Invalid index"};
+      }
+    return (*this)[i];
+  }
+
+  /**
+   * @param i An index.
+   * @return A const proxy to the row at index i.
+   */
+  const_reference at (const size_t &i) const noexcept (false)
+  {
+    if (i >= _size)
+      {
+        throw std::out_of_range{"Invalid index"};
+      }
+    return (*this)[i];
+  }
+
+  /**
+   * Inserts a row before the given position.
+   * @param position An iterator to the row that the new row will be
+   *                 inserted before.
+   * @param values The fields of the new row.
+   * @return An iterator to the new row.
+   */
+  iterator insert (const_iterator position, const Ts &... values)
+  noexcept (false)
+  {
+    const size_t index = position.index ();
+    grow (1);
+    shift_right (index, 1, fields ());
+    assign_row (index, fields (), values...);
+    ++_size;
+    return iterator (this, index);
+  }
+
+  /**
+   * Adds a new row to the end of the vector.
+   * @param values The fields of the new row.
+   */
+  void push_back (const Ts &... values) noexcept (false)
+  {
+    grow (1);
+    assign_row (_size, fields (), values...);
+    ++_size;
+  }
+
+  /**
+   * Deletes all the rows from first to last. When they fit again, the
+   * columns move back to the stack.
+   * @param first An iterator to the first row to delete.
+   * @param last An iterator to the last row to delete.
+   * @return An iterator to the row to the right of the deleted range.
+   */
+  iterator erase (const_iterator first, const_iterator last) noexcept (false)
+  {
+    const size_t index = first.index ();
+    shift_left (index, last.index (), fields ());
+    _size -= last.index () - index;
+    if (_cap != StaticCapacity && _size <= StaticCapacity)
+      {
+        relocate (StaticCapacity, fields ());
+      }
+    return iterator (this, index);
+  }
+
+  /**
+   * Deletes the row that 'it' points at from the vector.
+   * @param it An iterator to the row to delete.
+   * @return An iterator to the row to the right of the deleted row.
+   */
+  iterator erase (const_iterator it) noexcept (false)
+  {
+    return erase (it, it + 1);
+  }
+
+  /**
+   * Deletes the last row from the vector.
+   */
+  void pop_back () noexcept (false)
+  {
+    if (_size == 0)
+      {
+        return;
+      }
+    erase (end () - 1);
+  }
+
+  /**
+   * Changes the number of rows to count, by deleting the last rows or by
+   * adding rows of value initialized fields at the end.
+   * @param count The new number of rows.
+   */
+  void resize (const size_t count) noexcept (false)
+  {
+    if (count <= _size)
+      {
+        erase (begin () + count, end ());
+        return;
+      }
+    grow (count - _size);
+    for (; _size < count; ++_size)
+      {
+        assign_row (_size, fields (), Ts ()...);
+      }
+  }
+
+  /**
+   * Deletes all rows from the vector, and goes back to the stack.
+   */
+  void clear () noexcept (true)
+  {
+    free_heap (fields ());
+    _size = 0;
+    _cap = StaticCapacity;
+  }
+
+  /************* Operators Overloading **************/
+
+  /**
+   * @param i An index.
+   * @return A proxy to the row at index i.
+   */
+  reference operator[] (const size_t &i) noexcept (true)
+  {
+    return row (i, fields ());
+  }
+
+  /**
+   * @param i An index.
+   * @return A const proxy to the row at index i.
+   */
+  const_reference operator[] (const size_t &i) const noexcept (true)
+  {
+    return row (i, fields ());
+  }
+
+  /**
+   * Assignment operator - assigns another vector to this.
+   * @param rhs Another vector to assign.
+   * @return this.
+   */
+  vl_basic_soa_vector &operator= (const vl_basic_soa_vector &rhs)
+  noexcept (false)
+  {
+    if (this != &rhs)
+      {
+        clear ();
+        copy_from (rhs, fields ());
+      }
+    return *this;
+  }
+
+  /**
+   * Move assignment operator - steals the data of another vector and
+   * leaves it empty.
+   * @param rhs Another vector to move from.
+   * @return this.
+   */
+  vl_basic_soa_vector &operator= (vl_basic_soa_vector &&rhs) noexcept (true)
+  {
+    if (this != &rhs)
+      {
+        clear ();
+        move_from (rhs, fields ());
+      }
+    return *this;
+  }
+
+  /**
+   * Checks if both vectors have equal rows in the same order.
+   * @param rhs Another vector to compare with.
+   * @return true if this and rhs are equal, otherwise false.
+   */
+  bool operator== (const vl_basic_soa_vector &rhs) const noexcept (false)
+  {
+    return equal (rhs, fields ());
+  }
+
+  /**
+   * Checks if both vectors have equal rows in the same order.
+   * @param rhs Another vector to compare with.
+   * @return true if this and rhs are not equal, otherwise false.
+   */
+  bool operator!= (const vl_basic_soa_vector &rhs) const noexcept (false)
+  {
+    return !equal (rhs, fields ());
+  }
+
+ private:
+  /**
+   * @param i An index.
+   * @return A proxy to the row at index i.
+   */
+  template<const size_t... I>
+  reference row (const size_t i, std::index_sequence<I...>) noexcept (true)
+  {
+    return reference (data<I> ()[i]...);
+  }
+
+  /**
+   * @param i An index.
+   * @return A const proxy to the row at index i.
+   */
+  template<const size_t... I>
+  const_reference row (const size_t i, std::index_sequence<I...>) const
+  noexcept (true)
+  {
+    return const_reference (data<I> ()[i]...);
+  }
+};
+
+/**
+ * The static capacity of a vl_basic_soa_vector whose whole object takes
+ * about Bytes, like vl_budget_capacity for a vl_vector: a vector with one
+ * row on the stack, and as much more rows as fit in the rest. It's at least
+ * 1, since the columns must have a stack.
+ * @tparam Bytes The size budget of the whole object.
+ * @tparam Ts The types of the fields of a row.
+ */
+template<const size_t Bytes, typename... Ts>
+constexpr size_t vl_soa_budget_capacity =
+    (Bytes >= sizeof (vl_basic_soa_vector<1, Ts...>)) ?
+    (Bytes - sizeof (vl_basic_soa_vector<1, Ts...>)) / (sizeof (Ts) + ...) + 1
+    : 1;
+
+/**
+ * A vl_basic_soa_vector with as much rows on the stack as fit in
+ * DEFAULT_STATIC_BYTES.
+ * @tparam Ts The types of the fields of a row.
+ */
+template<typename... Ts>
+using vl_soa_vector =
+    vl_basic_soa_vector<vl_soa_budget_capacity<DEFAULT_STATIC_BYTES, Ts...>,
+                        Ts...>;
+
+#endif //_VL_SOA_VECTOR_H_
@@ -0,0 +1,453 @@
+#ifndef _VL_SORT_H_
+#define _VL_SORT_H_
+
+#include "vl_memory.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// ranges with less elements than this are sorted with std::sort.
+#ifndef RADIX_SORT_THRESHOLD
+#define RADIX_SORT_THRESHOLD 256
+#endif
+#define RADIX_BITS 8
+#define RADIX_BUCKETS (1 << RADIX_BITS)
+// ranges of arithmetic elements up to this size are sorted by networks.
+#ifndef SORT_NETWORK_MAX
+#define SORT_NETWORK_MAX 16
+#endif
+
+/**
+ * The unsigned integer type with the given size in bytes.
+ * @tparam Bytes 1, 2, 4 or 8.
+ */
+template<const size_t Bytes>
+struct vl_uint_of_size;
+
+template<>
+struct vl_uint_of_size<1> {
+  using type = uint8_t;
+};
+
+template<>
+struct vl_uint_of_size<2> {
+  using type = uint16_t;
+};
+
+template<>
+struct vl_uint_of_size<4> {
+  using type = uint32_t;
+};
+
+template<>
+struct vl_uint_of_size<8> {
+  using type = uint64_t;
+};
+
+/**
+ * true for the types that vl_sort_elements radix sorts: integral types
+ * other than bool, and IEEE float and double.
+ * @tparam T The type of the elements.
+ */
+template<typename T>
+constexpr bool vl_is_radix_sortable =
+    (std::is_integral<T>::value && !std::is_same<T, bool>::value
+     && sizeof (T) <= 8)
+    || (std::is_floating_point<T>::value
+        && std::numeric_limits<T>::is_iec559
+        && (sizeof (T) == 4 || sizeof (T) == 8));
+
+/**
+ * Maps a value to an unsigned key with the same order: the sign bit of
+ * signed integers is flipped, and so are all the bits of negative floating
+ * point numbers. Negative zero has the key of zero, since they are equal,
+ * and NaNs are placed at the ends according to their sign.
+ * @tparam T A radix sortable type.
+ * @param v A value.
+ * @return The key of v.
+ */
+template<typename T>
+typename vl_uint_of_size<sizeof (T)>::type vl_radix_key (const T &v)
+noexcept (true)
+{
+  using U = typename vl_uint_of_size<sizeof (T)>::type;
+  constexpr U sign = (U) ((U) 1 << (8 * sizeof (T) - 1));
+  U bits;
+  memcpy (&bits, &v, sizeof (T));
+  if constexpr (std::is_floating_point<T>::value)
+    {
+      bits = (bits == sign) ? (U) 0 : bits;
+      return (bits & sign) ? (U) ~bits : (U) (bits | sign);
+    }
+  else if constexpr (std::is_signed<T>::value)
+    {
+      return (U) (bits ^ sign);
+    }
+  else
+    {
+      return bits;
+    }
+}
+
+/**
+ * Sorts n elements in ascending order with a stable LSD radix sort, a byte
+ * at a time. The histograms of all the bytes are counted in a single pass,
+ * and bytes that are equal in all the elements are skipped.
+ * @tparam T A radix sortable type.
+ * @param data A pointer to the elements.
+ * @param n Number of elements, at least 1.
+ * @param scratch Memory for n elements, which doesn't overlap data.
+ */
+template<typename T>
+void vl_radix_sort (T *data, const size_t n, T *scratch) noexcept (true)
+{
+  constexpr size_t passes = sizeof (T);
+  size_t counts[passes][RADIX_BUCKETS] = {};
+  for (size_t i = 0; i < n; ++i)
+    {
+      const auto key = vl_radix_key (data[i]);
+      for (size_t p = 0; p < passes; ++p)
+        {
+          ++counts[p][(key >> (p * RADIX_BITS)) & (RADIX_BUCKETS - 1)];
+        }
+    }
+  T *src = data;
+  T *dst = scratch;
+  for (size_t p = 0; p < passes; ++p)
+    {
+      const size_t shift = p * RADIX_BITS;
+      size_t *offsets = counts[p];
+      if (offsets[(vl_radix_key (src[0]) >> shift) & (RADIX_BUCKETS - 1)]
+          == n)
+        {
+          continue;
+        }
+      size_t offset = 0;
+      for (size_t b = 0; b < RADIX_BUCKETS; ++b)
+        {
+          const size_t count = offsets[b];
+          offsets[b] = offset;
+          offset += count;
+        }
+      for (size_t i = 0; i < n; ++i)
+        {
+          const auto key = vl_radix_key (src[i]);
+          dst[offsets[(key >> shift) & (RADIX_BUCKETS - 1)]++] = src[i];
+        }
+      std::swap (src, dst);
+    }
+  if (src != data)
+    {
+      std::copy (src, src + n, data);
+    }
+}
+
+/**
+ * The order the elements are sorted in: operator<, except that IEEE
+ * floating point values are compared by their keys (see vl_radix_key), so
+ * NaNs are ordered too instead of breaking the sort.
+ * @tparam T The type of the elements.
+ * @param a An element.
+ * @param b Another element.
+ * @return true if a goes before b.
+ */
+template<typename T>
+bool vl_sort_less (const T &a, const T &b) noexcept (false)
+{
+  if constexpr (std::is_floating_point<T>::value && vl_is_radix_sortable<T>)
+    {
+      return vl_radix_key (a) < vl_radix_key (b);
+    }
+  else
+    {
+      return a < b;
+    }
+}
+
+/**
+ * Calls fn (a, b) for every comparator of Batcher's odd-even merge sort
+ * network for n elements, in order. Comparators within a layer don't
+ * share elements, so they can run in any order among themselves.
+ * @tparam Fn A callable that takes two indices, a < b.
+ * @param n Number of elements.
+ * @param fn The function to call.
+ */
+template<typename Fn>
+constexpr void vl_for_each_comparator (const size_t n, Fn fn) noexcept (true)
+{
+  for (size_t p = 1; p < n; p += p)
+    {
+      for (size_t k = p; k >= 1; k /= 2)
+        {
+          for (size_t j = k % p; j + k < n; j += 2 * k)
+            {
+              for (size_t i = 0; i < std::min (k, n - j - k); ++i)
+                {
+                  if ((i + j) / (2 * p) == (i + j + k) / (2 * p))
+                    {
+                      fn (i + j, i + j + k);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * The comparators of the sorting network for N elements, computed at
+ * compile time.
+ * @tparam N Number of elements.
+ */
+template<const size_t N>
+struct vl_sort_network {
+  /**
+   * @return the number of comparators.
+   */
+  static constexpr size_t count () noexcept (true)
+  {
+    size_t count = 0;
+    vl_for_each_comparator (N, [&count] (size_t, size_t) { ++count; });
+    return count;
+  }
+
+  size_t first[count () + 1]; // the lower index of every comparator.
+  size_t second[count () + 1]; // the higher index of every comparator.
+
+  /**
+   * @return the network, filled in.
+   */
+  static constexpr vl_sort_network make () noexcept (true)
+  {
+    vl_sort_network network{};
+    size_t i = 0;
+    vl_for_each_comparator (N, [&network, &i] (size_t a, size_t b) {
+      network.first[i] = a;
+      network.second[i] = b;
+      ++i;
+    });
+    return network;
+  }
+};
+
+/**
+ * Puts the smaller of two values in a and the larger in b, without
+ * branches: integers are selected with conditional moves, and floating
+ * point values with SIMD min/max instructions. Of two equal values, a gets
+ * the one that was in a and b the one that was in b, so zero and negative
+ * zero don't become two copies of one of them.
+ * @tparam T An arithmetic type, and no NaNs.
+ * @param a A value.
+ * @param b Another value.
+ */
+template<typename T>
+void vl_compare_exchange (T &a, T &b) noexcept (true)
+{
+  const T x = a;
+  const T y = b;
+#ifdef __SSE2__
+  // written with intrinsics, or the compiler sees the same comparison in
+  // both and swaps with a branch.
+  if constexpr (std::is_same<T, double>::value)
+    {
+      a = _mm_cvtsd_f64 (_mm_min_sd (_mm_set_sd (y), _mm_set_sd (x)));
+      b = _mm_cvtsd_f64 (_mm_max_sd (_mm_set_sd (x), _mm_set_sd (y)));
+      return;
+    }
+  else if constexpr (std::is_same<T, float>::value)
+    {
+      a = _mm_cvtss_f32 (_mm_min_ss (_mm_set_ss (y), _mm_set_ss (x)));
+      b = _mm_cvtss_f32 (_mm_max_ss (_mm_set_ss (x), _mm_set_ss (y)));
+      return;
+    }
+#endif
+  const bool swap = y < x;
+  a = swap ? y : x;
+  b = swap ? x : y;
+}
+
+/**
+ * @tparam T An arithmetic type.
+ * @param data A pointer to the elements.
+ * @param n Number of elements.
+ * @return true if there is a NaN among the elements, which the sorting
+ *         networks can't order.
+ */
+template<typename T>
+bool vl_has_nan (const T *data, const size_t n) noexcept (true)
+{
+  bool nan = false;
+  if constexpr (std::is_floating_point<T>::value)
+    {
+      for (size_t i = 0; i < n; ++i)
+        {
+          nan |= (data[i] != data[i]);
+        }
+    }
+  return nan;
+}
+
+/**
+ * Sorts N elements with the sorting network for N, fully unrolled, unless
+ * there is a NaN among them.
+ * @tparam T An arithmetic type.
+ * @tparam N Number of elements.
+ * @param data A pointer to the elements.
+ * @return true if the elements are sorted, false if they are left as they
+ *         are because there is a NaN among them.
+ */
+template<typename T, const size_t N, size_t... I>
+bool vl_network_sort (T *data, std::index_sequence<I...>) noexcept (true)
+{
+  if constexpr (sizeof... (I) > 0)
+    {
+      constexpr vl_sort_network<N> network = vl_sort_network<N>::make ();
+      T v[N];
+      memcpy (v, data, sizeof (v));
+      if (vl_has_nan (v, N))
+        {
+          return false;
+        }
+      (vl_compare_exchange (v[network.first[I]], v[network.second[I]]), ...);
+      memcpy (data, v, sizeof (v));
+    }
+  else
+    {
+      (void) data;
+    }
+  return true;
+}
+
+/**
+ * Sorts n elements with the sorting network for n, unless there is a NaN
+ * among them.
+ * @tparam T An arithmetic type.
+ * @param data A pointer to the elements.
+ * @param n Number of elements, at most SORT_NETWORK_MAX.
+ * @return true if the elements are sorted.
+ */
+template<typename T, size_t... N>
+bool vl_network_sort (T *data, const size_t n, std::index_sequence<N...>)
+noexcept (true)
+{
+  bool sorted = false;
+  ((n == N && (sorted = vl_network_sort<T, N> (
+      data, std::make_index_sequence<vl_sort_network<N>::count ()> ()),
+                true)) || ...);
+  return sorted;
+}
+
+/**
+ * Binary search whose loop has no data dependent branches: the next half is
+ * picked with a conditional move, so the CPU never mispredicts it, and the
+ * number of iterations depends only on n. The elements both possible next
+ * iterations compare are prefetched, to overlap their cache misses.
+ * @tparam T The type of the elements, ordered by operator<.
+ * @param data A pointer to n elements in ascending order.
+ * @param n Number of elements.
+ * @param value A value to search for.
+ * @return A pointer to the first element that isn't less than value, or
+ *         data + n if there is none.
+ */
+template<typename T>
+const T *vl_branchless_lower_bound (const T *data, size_t n, const T &value)
+noexcept (false)
+{
+  if (n == 0)
+    {
+      return data;
+    }
+  while (n > 1)
+    {
+      const size_t half = n / 2;
+      // both halves the next iteration may look at.
+      __builtin_prefetch (data + half / 2);
+      __builtin_prefetch (data + half + half / 2);
+      data = (data[half] < value) ? data + half : data;
+      n -= half;
+    }
+  return data + (*data < value);
+}
+
+/**
+ * Sorts n elements in ascending order. Ranges of radix sortable types
+ * (see vl_is_radix_sortable) with at least RADIX_SORT_THRESHOLD elements
+ * are radix sorted, which is stable, with the spare memory as scratch if
+ * it can hold n elements, or else with temporary heap memory. Ranges of
+ * arithmetic elements with at most SORT_NETWORK_MAX elements, like most
+ * vectors that stay inline, are sorted by branchless sorting networks,
+ * unless stable is true for floating point elements (negative zero and
+ * zero may swap) or there is a NaN among them. Everything else goes to
+ * std::sort, or std::stable_sort if stable is true, with vl_sort_less when
+ * there are NaNs. Either way NaNs go to the ends according to their sign.
+ * @tparam T The type of the elements.
+ * @param data A pointer to the elements.
+ * @param n Number of elements.
+ * @param spare Memory that isn't in use, right after the elements.
+ * @param spare_n How much elements fit in spare.
+ * @param stable true if equal elements must keep their order.
+ */
+template<typename T>
+void vl_sort_elements (T *data, const size_t n, T *spare,
+                       const size_t spare_n, const bool stable)
+noexcept (false)
+{
+  if constexpr (std::is_arithmetic<T>::value)
+    {
+      if (n <= SORT_NETWORK_MAX
+          && (!stable || std::is_integral<T>::value)
+          && vl_network_sort (
+              data, n, std::make_index_sequence<SORT_NETWORK_MAX + 1> ()))
+        {
+          return;
+        }
+    }
+  if constexpr (vl_is_radix_sortable<T>)
+    {
+      if (n >= RADIX_SORT_THRESHOLD)
+        {
+          if (spare_n >= n)
+            {
+              vl_radix_sort (data, n, spare);
+              return;
+            }
+          T *scratch = vl_allocate<T> (n, alignof (T));
+          vl_radix_sort (data, n, scratch);
+          vl_deallocate (scratch, n, alignof (T));
+          return;
+        }
+    }
+  if constexpr (std::is_floating_point<T>::value)
+    {
+      if (vl_has_nan (data, n))
+        {
+          const auto less = [] (const T &a, const T &b) {
+            return vl_sort_less (a, b);
+          };
+          if (stable)
+            {
+              std::stable_sort (data, data + n, less);
+            }
+          else
+            {
+              std::sort (data, data + n, less);
+            }
+          return;
+        }
+    }
+  if (stable)
+    {
+      std::stable_sort (data, data + n);
+    }
+  else
+    {
+      std::sort (data, data + n);
+    }
+}
+
+#endif //_VL_SORT_H_
@@ -0,0 +1,119 @@
+#ifndef _VL_SORTED_INDEX_H_
+#define _VL_SORTED_INDEX_H_
+
+#include "vl_vector.h"
+#include <cstddef>
+
+/**
+ * A search index over a sorted range, for large tables where the binary
+ * search is bound by cache misses. The elements are copied in Eytzinger
+ * (BFS) order: the children of node k are nodes 2k and 2k + 1, so the
+ * nodes of the next levels of a search are close together, and the
+ * descendants LOG2 (CACHE_LINE_SIZE / sizeof (T)) levels down share a cache
+ * line, which is prefetched while the levels above it are compared.
+ * The tree is padded to a perfect one with copies of the largest element,
+ * so it takes less than twice the memory of the range, and the position of
+ * a search in the range is known in O(1) from where it ends in the tree.
+ * The index doesn't refer to the range, and isn't updated with it.
+ * @tparam T The type of the elements, ordered by operator<.
+ */
+template<typename T>
+class vl_sorted_index {
+ private:
+  /************* Private Fields **************/
+  // the nodes, in BFS order from index 1; aligned to cache lines.
+  vl_vector<T, 0, CACHE_LINE_SIZE> _tree;
+  size_t _size; // number of elements in the original range.
+  size_t _leaves; // 2 ^ height of the tree, the leaf after the last node.
+
+  /************* Private Methods **************/
+
+  /**
+   * @param rank A position in the sorted range, less than _leaves - 1.
+   * @return the index of the node of that position in the tree.
+   */
+  size_t node_of (const size_t rank) const noexcept (true)
+  {
+    // the trailing zeros of rank + 1 are the height of the node.
+    const size_t in_order = rank + 1;
+    const size_t height = __builtin_ctzll (in_order);
+    return (_leaves >> (height + 1)) + (in_order >> (height + 1));
+  }
+
+ public:
+  /************* Constructors **************/
+
+  /**
+   * Builds the index of the sorted range [first, last).
+   * @param first A pointer to the first element.
+   * @param last A pointer past the last element.
+   */
+  vl_sorted_index (const T *first, const T *last) :
+      _size (last - first), _leaves (1)
+  {
+    while (_leaves <= _size)
+      {
+        _leaves *= 2;
+      }
+    _tree = vl_vector<T, 0, CACHE_LINE_SIZE> (_leaves, T ());
+    for (size_t rank = 0; rank + 1 < _leaves; ++rank)
+      {
+        _tree[node_of (rank)] = first[rank < _size ? rank : _size - 1];
+      }
+  }
+
+  /************* Public Methods **************/
+
+  /**
+   * @return the number of elements in the indexed range.
+   */
+  size_t size () const noexcept (true)
+  {
+    return _size;
+  }
+
+  /**
+   * @return true if the indexed range is empty, otherwise false.
+   */
+  bool empty () const noexcept (true)
+  {
+    return _size == 0;
+  }
+
+  /**
+   * Searches down the tree without branches, prefetching the cache line of
+   * the descendants a few levels ahead.
+   * @param value A value to search for.
+   * @return the position in the indexed range of the first element that
+   *         isn't less than value, or size () if there is none.
+   */
+  size_t lower_bound (const T &value) const noexcept (false)
+  {
+    constexpr size_t block = (sizeof (T) < CACHE_LINE_SIZE) ?
+                             CACHE_LINE_SIZE / sizeof (T) : 1;
+    const T *tree = _tree.data ();
+    size_t k = 1;
+    while (k < _leaves)
+      {
+        // prefetching past the end is harmless, as it never faults.
+        __builtin_prefetch ((const char *) tree + k * block * sizeof (T));
+        k = 2 * k + (tree[k] < value);
+      }
+    // the leaf the search ends at is the number of elements less than value.
+    const size_t rank = k - _leaves;
+    return (rank < _size) ? rank : _size;
+  }
+
+  /**
+   * @param value A value to search for.
+   * @return true if the indexed range contains the value, otherwise false.
+   */
+  bool contains (const T &value) const noexcept (false)
+  {
+    const size_t rank = lower_bound (value);
+    return rank < _size && !(value < _tree[node_of (rank)]);
+  }
+
+};
+
+#endif //_VL_SORTED_INDEX_H_
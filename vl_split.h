@@ -0,0 +1,402 @@
+#ifndef _VL_SPLIT_H_
+#define _VL_SPLIT_H_
+
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// delimiter sets of up to this many characters are scanned with SSE2.
+#ifndef TOKEN_SIMD_DELIMS
+#define TOKEN_SIMD_DELIMS 4
+#endif
+
+/**
+ * A lazy range over the fields of a string, separated by a single
+ * delimiter. Every field is a std::string_view into the original buffer,
+ * so nothing is allocated or copied. Consecutive delimiters produce empty
+ * fields, as in CSV/TSV, and so does an empty string: a single empty field.
+ */
+class vl_split_range {
+ private:
+  /************* Private Fields **************/
+  std::string_view _str; // the string to split.
+  char _delim; // the delimiter between the fields.
+
+ public:
+  /************* Iterator **************/
+
+  /**
+   * A forward iterator over the fields of the string.
+   */
+  class iterator {
+   private:
+    const char *_first; // beginning of the current field, nullptr at end.
+    const char *_last; // end of the current field.
+    const char *_end; // end of the whole string.
+    char _delim; // the delimiter between the fields.
+
+    /**
+     * @return a pointer to the next delimiter from _first, or _end.
+     */
+    const char *find_delim () const noexcept (true)
+    {
+      if (_first == _end)
+        {
+          return _end;
+        }
+      // memchr is vectorized by the C library.
+      auto found = static_cast<const char *> (
+          memchr (_first, _delim, _end - _first));
+      return found ? found : _end;
+    }
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view *;
+    using reference = std::string_view;
+
+    /**
+     * Constructs the end iterator.
+     */
+    iterator () :
+        _first (nullptr),
+        _last (nullptr),
+        _end (nullptr),
+        _delim ('\0')
+    {}
+
+    /**
+     * Constructs an iterator to the first field of str.
+     * @param str The string to split.
+     * @param delim The delimiter between the fields.
+     */
+    iterator (std::string_view str, const char delim) :
+        _first (str.data ()),
+        _last (nullptr),
+        _end (str.data () + str.size ()),
+        _delim (delim)
+    {
+      // a default string_view has no data, which would look like the end.
+      if (_first == nullptr)
+        {
+          _first = _end = "";
+        }
+      _last = find_delim ();
+    }
+
+    /**
+     * @return the current field.
+     */
+    std::string_view operator* () const noexcept (true)
+    {
+      return std::string_view (_first, _last - _first);
+    }
+
+    /**
+     * Advances to the next field.
+     * @return this.
+     */
+    iterator &operator++ () noexcept (true)
+    {
+      if (_last == _end)
+        {
+          _first = nullptr;
+          return *this;
+        }
+      _first = _last + 1;
+      _last = find_delim ();
+      return *this;
+    }
+
+    /**
+     * Advances to the next field.
+     * @return a copy of this before advancing.
+     */
+    iterator operator++ (int) noexcept (true)
+    {
+      iterator it (*this);
+      ++*this;
+      return it;
+    }
+
+    /**
+     * @param rhs Another iterator to compare with.
+     * @return true if both iterators point at the same position.
+     */
+    bool operator== (const iterator &rhs) const noexcept (true)
+    {
+      return _first == rhs._first;
+    }
+
+    /**
+     * @param rhs Another iterator to compare with.
+     * @return true if the iterators point at different positions.
+     */
+    bool operator!= (const iterator &rhs) const noexcept (true)
+    {
+      return _first != rhs._first;
+    }
+  };
+
+  /************* Constructors **************/
+
+  /**
+   * @param str The string to split.
+   * @param delim The delimiter between the fields.
+   */
+  vl_split_range (std::string_view str, const char delim) :
+      _str (str),
+      _delim (delim)
+  {}
+
+  /************* Methods **************/
+
+  /**
+   * @return an iterator to the first field.
+   */
+  iterator begin () const noexcept (true)
+  {
+    return iterator (_str, _delim);
+  }
+
+  /**
+   * @return an iterator past the last field.
+   */
+  iterator end () const noexcept (true)
+  {
+    return iterator ();
+  }
+};
+
+/**
+ * A lazy range over the tokens of a string, separated by runs of any of
+ * the characters of a delimiter set. Every token is a std::string_view
+ * into the original buffer, and empty tokens are skipped. Sets of up to
+ * TOKEN_SIMD_DELIMS characters are scanned 16 bytes at a time with SSE2,
+ * and larger ones a byte at a time with a lookup table.
+ */
+class vl_token_range {
+ private:
+  /************* Private Fields **************/
+  std::string_view _str; // the string to tokenize.
+  bool _is_delim[256]; // a lookup table of the delimiter characters.
+  char _delims[TOKEN_SIMD_DELIMS]; // the delimiter characters.
+  size_t _simd_count; // number of _delims, 0 if there are too many.
+
+ public:
+  /************* Iterator **************/
+
+  /**
+   * A forward iterator over the tokens of the string.
+   */
+  class iterator {
+   private:
+    const char *_first; // beginning of the current token, nullptr at end.
+    const char *_last; // end of the current token.
+    const char *_end; // end of the whole string.
+    const vl_token_range *_range; // the range, with the delimiters.
+
+    /**
+     * @param c A character.
+     * @return true if c is one of the delimiters, otherwise false.
+     */
+    bool is_delim (const char c) const noexcept (true)
+    {
+      return _range->_is_delim[(unsigned char) c];
+    }
+
+    /**
+     * Skips the delimiters or the other characters from p.
+     * @param p A pointer into the string.
+     * @param delims true to skip delimiters, false to skip the others.
+     * @return a pointer to the first character from p that isn't skipped,
+     *         or _end.
+     */
+    const char *skip (const char *p, const bool delims) const noexcept (true)
+    {
+#ifdef __SSE2__
+      const size_t count = _range->_simd_count;
+      if (count != 0)
+        {
+          const uint32_t flip = delims ? 0xFFFF : 0;
+          while (_end - p >= 16)
+            {
+              const __m128i block =
+                  _mm_loadu_si128 (reinterpret_cast<const __m128i *> (p));
+              __m128i match = _mm_setzero_si128 ();
+              for (size_t i = 0; i < count; ++i)
+                {
+                  match = _mm_or_si128 (
+                      match,
+                      _mm_cmpeq_epi8 (block,
+                                      _mm_set1_epi8 (_range->_delims[i])));
+                }
+              // a bit for every character that isn't skipped.
+              const uint32_t stop =
+                  (uint32_t) _mm_movemask_epi8 (match) ^ flip;
+              if (stop != 0)
+                {
+                  return p + __builtin_ctz (stop);
+                }
+              p += 16;
+            }
+        }
+#endif
+      while (p != _end && is_delim (*p) == delims)
+        {
+          ++p;
+        }
+      return p;
+    }
+
+    /**
+     * Finds the token that starts at or after p.
+     * @param p A pointer into the string.
+     */
+    void next_token (const char *p) noexcept (true)
+    {
+      p = skip (p, true);
+      if (p == _end)
+        {
+          _first = nullptr;
+          return;
+        }
+      _first = p;
+      _last = skip (p, false);
+    }
+
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view *;
+    using reference = std::string_view;
+
+    /**
+     * Constructs the end iterator.
+     */
+    iterator () :
+        _first (nullptr),
+        _last (nullptr),
+        _end (nullptr),
+        _range (nullptr)
+    {}
+
+    /**
+     * Constructs an iterator to the first token of str.
+     * @param str The string to tokenize.
+     * @param range The range, with the delimiters.
+     */
+    iterator (std::string_view str, const vl_token_range *range) :
+        _first (nullptr),
+        _last (nullptr),
+        _end (str.data () + str.size ()),
+        _range (range)
+    {
+      next_token (str.data ());
+    }
+
+    /**
+     * @return the current token.
+     */
+    std::string_view operator* () const noexcept (true)
+    {
+      return std::string_view (_first, _last - _first);
+    }
+
+    /**
+     * Advances to the next token.
+     * @return this.
+     */
+    iterator &operator++ () noexcept (true)
+    {
+      next_token (_last);
+      return *this;
+    }
+
+    /**
+     * Advances to the next token.
+     * @return a copy of this before advancing.
+     */
+    iterator operator++ (int) noexcept (true)
+    {
+      iterator it (*this);
+      ++*this;
+      return it;
+    }
+
+    /**
+     * @param rhs Another iterator to compare with.
+     * @return true if both iterators point at the same position.
+     */
+    bool operator== (const iterator &rhs) const noexcept (true)
+    {
+      return _first == rhs._first;
+    }
+
+    /**
+     * @param rhs Another iterator to compare with.
+     * @return true if the iterators point at different positions.
+     */
+    bool operator!= (const iterator &rhs) const noexcept (true)
+    {
+      return _first != rhs._first;
+    }
+  };
+
+  /************* Constructors **************/
+
+  /**
+   * @param str The string to tokenize.
+   * @param delims The delimiter characters.
+   */
+  vl_token_range (std::string_view str, std::string_view delims) :
+      _str (str),
+      _is_delim{},
+      _delims{},
+      _simd_count (0)
+  {
+    size_t count = 0;
+    for (char c : delims)
+      {
+        if (!_is_delim[(unsigned char) c])
+          {
+            _is_delim[(unsigned char) c] = true;
+            if (count < TOKEN_SIMD_DELIMS)
+              {
+                _delims[count] = c;
+              }
+            ++count;
+          }
+      }
+    _simd_count = (count <= TOKEN_SIMD_DELIMS) ? count : 0;
+  }
+
+  /************* Methods **************/
+
+  /**
+   * Note that the iterators use the delimiters of this range, so it must
+   * outlive them.
+   * @return an iterator to the first token.
+   */
+  iterator begin () const noexcept (true)
+  {
+    return iterator (_str, this);
+  }
+
+  /**
+   * @return an iterator past the last token.
+   */
+  iterator end () const noexcept (true)
+  {
+    return iterator ();
+  }
+};
+
+#endif //_VL_SPLIT_H_
@@ -0,0 +1,433 @@
+#ifndef _VL_STATIC_VECTOR_H_
+#define _VL_STATIC_VECTOR_H_
+
+#include "vl_vector.h"
+
+/**
+ * Represents a vector with a fixed capacity, that keeps all of its elements
+ * in the static memory (Stack) like a vl_vector that never spills. It never
+ * allocates, and holds only the elements and the size, so it's trivially
+ * copyable whenever T is, and can be copied with memcpy or placed in shared
+ * memory.
+ * It keeps the inline storage of vl_vector, an array of Capacity elements
+ * that are always constructed, but doesn't derive from vl_vector_ref: that
+ * base has a virtual destructor and a heap pointer, so nothing built on it
+ * can be trivially copyable.
+ * @tparam T The type of the elements that the vector will operate on.
+ * @tparam Capacity The maximal amount of elements the vector can hold.
+ */
+template<typename T, const size_t Capacity = DEFAULT_STATIC_CAPACITY>
+class vl_static_vector {
+ private:
+  /************* Private Fields **************/
+  T _data[Capacity]; // holds the data in the stack memory.
+  size_t _size; // size of this vector.
+
+ public:
+  /************* Constructors **************/
+
+  /**
+   * Default constructor which initializes empty vl_static_vector.
+   */
+  vl_static_vector () : _size (0)
+  {}
+
+  /**
+   * Sequence based constructor. Gets a range of elements - [first, last),
+   * and stores them in the vector.
+   * @tparam ForwardIterator the type of iterator.
+   * @param first An iterator that represents the first element.
+   * @param last An iterator that represents the last element.
+   */
+  template<class ForwardIterator>
+  vl_static_vector (ForwardIterator first, ForwardIterator last) :
+      vl_static_vector ()
+  {
+    insert (begin (), first, last);
+  }
+
+  /**
+   * Single value initialized constructor. Initializes the vector with
+   * 'count' number of elements that has the value 'v'.
+   * @param count Number of elements to initialize.
+   * @param v The value to initalize with.
+   */
+  vl_static_vector (const size_t &count, const T &v) : vl_static_vector ()
+  {
+    if (count > Capacity)
+      {
+        throw std::length_error{"Capacity exceeded"};
+      }
+    std::fill_n (_data, count, v);
+    _size = count;
+  }
+
+  /************* Iterator, Reverse Iterator and their Const **************/
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  /**
+   * @return an iterator to the beginning of the data.
+   */
+  iterator begin () noexcept (true)
+  {
+    return _data;
+  }
+
+  /**
+   * @return an iterator to the end of the data.
+   */
+  iterator end () noexcept (true)
+  {
+    return _data + _size;
+  }
+
+  /**
+   * @return a const iterator to the beginning of the data.
+   */
+  const_iterator begin () const noexcept (true)
+  {
+    return _data;
+  }
+
+  /**
+   * @return a const iterator to the end of the data.
+   */
+  const_iterator end () const noexcept (true)
+  {
+    return _data + _size;
+  }
+
+  /**
+   * @return a const iterator to the beginning of the data.
+   */
+  const_iterator cbegin () const noexcept (true)
+  {
+    return _data;
+  }
+
+  /**
+   * @return a const iterator to the end of the data.
+   */
+  const_iterator cend () const noexcept (true)
+  {
+    return _data + _size;
+  }
+
+  /**
+   * @return a reversed iterator to the beginning of the data.
+   */
+  reverse_iterator rbegin () noexcept (true)
+  {
+    return reverse_iterator (end ());
+  }
+
+  /**
+   * @return a reversed iterator to the end of the data.
+   */
+  reverse_iterator rend () noexcept (true)
+  {
+    return reverse_iterator (begin ());
+  }
+
+  /**
+   * @return a const reversed iterator to the beginning of the data.
+   */
+  const_reverse_iterator rbegin () const noexcept (true)
+  {
+    return const_reverse_iterator (end ());
+  }
+
+  /**
+   * @return a const reversed iterator to the end of the data.
+   */
+  const_reverse_iterator rend () const noexcept (true)
+  {
+    return const_reverse_iterator (begin ());
+  }
+
+  /**
+   * @return a const reversed iterator to the beginning of the data.
+   */
+  const_reverse_iterator crbegin () const noexcept (true)
+  {
+    return const_reverse_iterator (cend ());
+  }
+
+  /**
+   * @return a const reversed iterator to the end of the data.
+   */
+  const_reverse_iterator crend () const noexcept (true)
+  {
+    return const_reverse_iterator (cbegin ());
+  }
+
+  /************* Public Methods **************/
+
+  /**
+   * @return a pointer to the data.
+   */
+  T *data () noexcept (true)
+  {
+    return _data;
+  }
+
+  /**
+   * @return a const pointer to the data.
+   */
+  const T *data () const noexcept (true)
+  {
+    return _data;
+  }
+
+  /**
+   * @param element A reference to const T.
+   * @return true if the vector contains the element, otherwise false.
+   */
+  bool contains (const T &element) const noexcept (false)
+  {
+    return std::find (begin (), end (), element) != end ();
+  }
+
+  /**
+   * @return the current amount of elements in the vector.
+   */
+  size_t size () const noexcept (true)
+  {
+    return _size;
+  }
+
+  /**
+   * @return the capacity of the vector, which never changes.
+   */
+  static constexpr size_t capacity () noexcept (true)
+  {
+    return Capacity;
+  }
+
+  /**
+   * @return true if the vector is empty, otherwise false.
+   */
+  bool empty () const noexcept (true)
+  {
+    return _size == 0;
+  }
+
+  /**
+   * @return true if the vector can't hold any more elements,
+   *         otherwise false.
+   */
+  bool full () const noexcept (true)
+  {
+    return _size == Capacity;
+  }
+
+  /**
+   * @param i An index.
+   * @return A reference to the element at index i in the vector.
+   */
+  T &at (const size_t &i) noexcept (false)
+  {
+    if (i >= _size)
+      {
+        throw std::out_of_range{"Invalid index"};
+      }
+    return _data[i];
+  }
+
+  /**
+   * @param i An index.
+   * @return The element at index i in the vector.
+   */
+  T at (const size_t &i) const noexcept (false)
+  {
+    if (i >= _size)
+      {
+        throw std::out_of_range{"Invalid index"};
+      }
+    return _data[i];
+  }
+
+  /**
+   * Inserts all the element from first to end (not included) before
+   * the given position. Throws std::length_error, without changing the
+   * vector, if they don't fit.
+   * @tparam ForwardIterator An iterator over the range we want to insert.
+   * @param position A pointer to a const T that the range of elements will
+   *                 be inserted before it.
+   * @param first An iterator to the first element in the given range.
+   * @param end An iterator to the last element (not included) in the
+   *            given range.
+   * @return An iterator to the first element in the inserted range.
+   */
+  template<class ForwardIterator>
+  iterator insert (const_iterator position, ForwardIterator first,
+                   ForwardIterator last) noexcept (false)
+  {
+    iterator pos = (iterator) position;
+    size_t k = last - first; // number of new elements to add
+    if (k > Capacity - _size)
+      {
+        throw std::length_error{"Capacity exceeded"};
+      }
+    // where the range is, if it's a part of this vector.
+    const size_t from = vl_alias_index (_data, _size, first);
+    std::move_backward (pos, end (), end () + k);
+    if (from == _size)
+      {
+        std::copy (first, last, pos);
+      }
+    else
+      {
+        vl_copy_shifted (_data, pos - _data, from, k);
+      }
+    _size += k;
+    return pos;
+  }
+
+  /**
+   * Inserts the given element before position. Throws std::length_error
+   * if the vector is full.
+   * @param position A pointer to a const T that the element will be inserted
+   *                 before it.
+   * @param element An element to insert.
+   * @return An iterator to the new element that has been added.
+   */
+  iterator insert (const_iterator position, const T &element) noexcept (false)
+  {
+    return insert (position, &element, &element + 1);
+  }
+
+  /**
+   * Adds a new element to the end of the vector if there is room for it.
+   * @param element An element to add.
+   * @return true if the element was added, false if the vector is full.
+   */
+  bool try_push_back (const T &element)
+  noexcept (std::is_nothrow_copy_assignable<T>::value)
+  {
+    if (_size == Capacity)
+      {
+        return false;
+      }
+    _data[_size++] = element;
+    return true;
+  }
+
+  /**
+   * Adds a new element to the end of the vector, without checking that
+   * there is room for it. The vector must not be full.
+   * @param element An element to add.
+   */
+  void unchecked_push_back (const T &element)
+  noexcept (std::is_nothrow_copy_assignable<T>::value)
+  {
+    _data[_size++] = element;
+  }
+
+  /**
+   * Adds a new element to the end of the vector. Throws std::length_error
+   * if the vector is full.
+   * @param element An element to add.
+   */
+  void push_back (const T &element) noexcept (false)
+  {
+    if (!try_push_back (element))
+      {
+        throw std::length_error{"Capacity exceeded"};
+      }
+  }
+
+  /**
+   * Deletes all elements from first to last in this vector.
+   * @param first An iterator to the first element to delete.
+   * @param last An iterator to the last element to delete.
+   * @return An iterator to the element to the right of the deleted range.
+   */
+  iterator erase (const_iterator first, const_iterator last)
+  noexcept (std::is_nothrow_move_assignable<T>::value)
+  {
+    std::move ((iterator) last, end (), (iterator) first);
+    _size -= last - first;
+    return (iterator) first;
+  }
+
+  /**
+   * Deletes the element that 'it' points at from the vector.
+   * @param it A pointer to const T that will be deleted.
+   * @return An iterator to the element to the right of the deleted element.
+   */
+  iterator erase (const_iterator it)
+  noexcept (std::is_nothrow_move_assignable<T>::value)
+  {
+    return erase (it, it + 1);
+  }
+
+  /**
+   * Deletes the last element from the vector.
+   */
+  void pop_back () noexcept (true)
+  {
+    if (_size == 0)
+      {
+        return;
+      }
+    --_size;
+  }
+
+  /**
+   * Deletes all elements from the vector.
+   */
+  void clear () noexcept (true)
+  {
+    _size = 0;
+  }
+
+  /************* Operators Overloading **************/
+
+  /**
+   * @param i An index which belongs to [0,size of vector).
+   * @return A reference to the element at the index.
+   */
+  T &operator[] (const size_t &i) noexcept (true)
+  {
+    return _data[i];
+  }
+
+  /**
+   * @param i An index which belongs to [0,size of vector).
+   * @return The element at the index.
+   */
+  T operator[] (const size_t &i) const noexcept (true)
+  {
+    return _data[i];
+  }
+
+  /**
+   * Checks if both object's size and elements are equal, and they appear
+   * at the same order.
+   * @param rhs Another vl_static_vector object to compare with.
+   * @return true if this and rhs are equal, otherwise false.
+   */
+  bool operator== (const vl_static_vector &rhs) const noexcept (false)
+  {
+    return (_size == rhs._size) && std::equal (begin (), end (), rhs.begin ());
+  }
+
+  /**
+   * Checks if both object's size and elements are equal, and they appear
+   * at the same order.
+   * @param rhs Another vl_static_vector object to compare with.
+   * @return true if this and rhs are not equal, otherwise false.
+   */
+  bool operator!= (const vl_static_vector &rhs) const noexcept (false)
+  {
+    return !(*this == rhs);
+  }
+
+};
+
+#endif //_VL_STATIC_VECTOR_H_
@@ -2,9 +2,30 @@
 #define _VL_STRING_H_
 
 #include "vl_vector.h"
+#include "vl_split.h"
+#include <charconv>
 #include <cstring>
+#include <string_view>
 
-template<const size_t StaticCapacity = DEFAULT_STATIC_CAPACITY>
+// enough characters for any integer or the shortest form of any float.
+#define MAX_NUMBER_CHARS 32
+
+/**
+ * Formats the given number with std::to_chars into a local buffer, so that
+ * callers append only the characters that were written.
+ * @tparam Number An arithmetic type.
+ * @param buf A buffer to format into.
+ * @param n A number to format.
+ * @return The number of characters written.
+ */
+template<typename Number>
+size_t vl_format_number (char (&buf)[MAX_NUMBER_CHARS], const Number n)
+noexcept (true)
+{
+  return std::to_chars (buf, buf + MAX_NUMBER_CHARS, n).ptr - buf;
+}
+
+template<const size_t StaticCapacity = vl_budget_capacity<char>>
 class vl_string : public vl_vector<char, StaticCapacity> {
  public:
   /************* Constructors & Destructor **************/
@@ -18,16 +39,72 @@ class vl_string : public vl_vector<char, StaticCapacity> {
     this->_size = 1;
   }
 
+  /**
+   * Copy Constructor.
+   * @param str A vl_string object to copy from.
+   */
+  vl_string (const vl_string &str) = default;
+
+  /**
+   * Copies a vl_string of another static capacity. Without it, converting
+   * one would be ambiguous between const char * and std::string_view.
+   * @param str A vl_string object to copy from.
+   */
+  template<const size_t M>
+  vl_string (const vl_string<M> &str) : vl_string (str.data (), str.size ())
+  {}
+
+  /**
+   * Move Constructor. Leaves str as an empty string.
+   * @param str A vl_string object to move from.
+   */
+  vl_string (vl_string &&str) noexcept (true) :
+      vl_vector<char, StaticCapacity> (std::move (str))
+  {
+    str._stack_data[0] = '\0';
+    str._size = 1;
+  }
+
+  /**
+   * Adopts the characters of the given vector (which must not contain the
+   * '\0' terminator) by move, and terminates them.
+   * @param chars A vl_vector of characters to take over.
+   */
+  explicit vl_string (vl_vector<char, StaticCapacity> &&chars) :
+      vl_vector<char, StaticCapacity> (std::move (chars))
+  {
+    this->insert (this->end (), '\0');
+  }
+
   /**
    * Implicit constructor that stores the characters of the given string
    * in this object.
    * @param str A string to store.
    */
-  vl_string (const char *str) :
-      vl_vector<char, StaticCapacity> (str, str + strlen (str) + 1)
+  vl_string (const char *str) : vl_string (str, strlen (str))
+  {}
+
+  /**
+   * Constructor that stores the first 'len' characters of the given string
+   * in this object, without scanning it for '\0'.
+   * @param str A pointer to the characters to store.
+   * @param len Number of characters to store.
+   */
+  vl_string (const char *str, const size_t len) : vl_string ()
+  {
+    append (str, len);
+  }
+
+  /**
+   * Implicit constructor that stores the characters of the given string
+   * view in this object.
+   * @param sv A string view to store.
+   */
+  vl_string (std::string_view sv) : vl_string (sv.data (), sv.size ())
   {}
 
 
+ public:
   /************* Methods **************/
 
   /**
@@ -39,6 +116,134 @@ class vl_string : public vl_vector<char, StaticCapacity> {
     return strstr (this->begin (), str);
   }
 
+  /**
+   * Appends the first 'len' characters of the given string to this.
+   * @param str A pointer to the characters to append.
+   * @param len Number of characters to append.
+   * @return this.
+   */
+  vl_string &append (const char *str, const size_t len) noexcept (false)
+  {
+    this->insert (this->data () + size (), str, str + len);
+    return *this;
+  }
+
+  /**
+   * Appends the characters of the given string view to this.
+   * @param sv A string view to append.
+   * @return this.
+   */
+  vl_string &append (std::string_view sv) noexcept (false)
+  {
+    return append (sv.data (), sv.size ());
+  }
+
+  /**
+   * Appends the given vl_string object, of any static capacity, to this.
+   * @param str A vl_string object to append.
+   * @return this.
+   */
+  template<const size_t M>
+  vl_string &append (const vl_string<M> &str) noexcept (false)
+  {
+    return append (str.data (), str.size ());
+  }
+
+  /**
+   * Appends the given signed integer in decimal.
+   * @param n An integer to append.
+   * @return this.
+   */
+  vl_string &append_int (const long long n) noexcept (false)
+  {
+    char buf[MAX_NUMBER_CHARS];
+    return append (buf, vl_format_number (buf, n));
+  }
+
+  /**
+   * Appends the given unsigned integer in decimal.
+   * @param n An integer to append.
+   * @return this.
+   */
+  vl_string &append_uint (const unsigned long long n) noexcept (false)
+  {
+    char buf[MAX_NUMBER_CHARS];
+    return append (buf, vl_format_number (buf, n));
+  }
+
+  /**
+   * Appends the given number in its shortest form that still parses back
+   * to the same value.
+   * @param n A number to append.
+   * @return this.
+   */
+  vl_string &append_double (const double n) noexcept (false)
+  {
+    char buf[MAX_NUMBER_CHARS];
+    return append (buf, vl_format_number (buf, n));
+  }
+
+  /**
+   * Parses the whole string as a number.
+   * @tparam Number An arithmetic type.
+   * @return The parsed number.
+   */
+  template<typename Number>
+  Number parse () const noexcept (false)
+  {
+    Number n{};
+    const char *last = this->data () + size ();
+    auto result = std::from_chars (this->data (), last, n);
+    if (result.ec == std::errc::result_out_of_range)
+      {
+        throw std::out_of_range{"Number out of range"};
+      }
+    if (result.ec != std::errc () || result.ptr != last)
+      {
+        throw std::invalid_argument{"Invalid number"};
+      }
+    return n;
+  }
+
+  /**
+   * @param delim A delimiter character.
+   * @return a lazy range of string views over the fields of this that are
+   *         separated by delim. Empty fields are kept.
+   */
+  vl_split_range split (const char delim) const noexcept (true)
+  {
+    return vl_split_range (std::string_view (this->data (), size ()), delim);
+  }
+
+  /**
+   * @param delims A set of delimiter characters.
+   * @return a lazy range of string views over the non-empty tokens of this
+   *         that are separated by any of the characters in delims.
+   */
+  vl_token_range tokenize (std::string_view delims) const noexcept (true)
+  {
+    return vl_token_range (std::string_view (this->data (), size ()), delims);
+  }
+
+  /**
+   * Appends string views over the fields of this that are separated by
+   * delim to the given vector.
+   * @param fields A vector of any static capacity to append the fields to.
+   * @param delim A delimiter character.
+   * @return The number of fields that were appended.
+   */
+  size_t split_into (vl_vector_ref<std::string_view> &fields,
+                     const char delim) const noexcept (false)
+  {
+    size_t count = 0;
+    for (std::string_view field : split (delim))
+      {
+        fields.push_back (field);
+        ++count;
+      }
+    return count;
+  }
+
   /**
    * @return the current amount of characters in the vector, without '\0'.
    */
@@ -52,22 +257,38 @@ class vl_string : public vl_vector<char, StaticCapacity> {
    */
   void clear () noexcept (false) override
   {
+    this->release ();
+    this->_stack_data[0] = '\0';
     this->_size = 1;
-    if (this->_cap == StaticCapacity)
-      {
-        return;
-      }
-    else
-      {
-        delete[] this->_heap_data;
-        this->_heap_data = nullptr;
-        this->_cap = StaticCapacity;
-        this->_stack_data[0] = '\0';
-      }
   }
 
+
   /************* Operators Overloading **************/
 
+  /**
+   * Assignment operator - assigns another vl_string to this.
+   * @param rhs Another vl_string object to assign.
+   * @return this.
+   */
+  vl_string &operator= (const vl_string &rhs) = default;
+
+  /**
+   * Move assignment operator - steals the data of another vl_string and
+   * leaves it as an empty string.
+   * @param rhs Another vl_string object to move from.
+   * @return this.
+   */
+  vl_string &operator= (vl_string &&rhs) noexcept (true)
+  {
+    if (this != &rhs)
+      {
+        vl_vector<char, StaticCapacity>::operator= (std::move (rhs));
+        rhs._stack_data[0] = '\0';
+        rhs._size = 1;
+      }
+    return *this;
+  }
+
   /**
    * Concatenates the given character with this.
    * @param rhs A character to concatenate with.
@@ -86,18 +307,29 @@ class vl_string : public vl_vector<char, StaticCapacity> {
    */
   vl_string &operator+= (const char *rhs) noexcept (false)
   {
-    this->insert (this->data() + this->size(), rhs, rhs + strlen (rhs));
-    return *this;
+    return append (rhs, strlen (rhs));
   }
 
   /**
-   * Concatenates the given vl_string object with this.
+   * Concatenates the given vl_string object, of any static capacity, with
+   * this.
    * @param rhs A vl_string object to concatenate with.
    * @return this.
    */
-  vl_string &operator+= (const vl_string &rhs) noexcept (false)
+  template<const size_t M>
+  vl_string &operator+= (const vl_string<M> &rhs) noexcept (false)
   {
-    return *this += rhs.cbegin ();
+    return append (rhs);
+  }
+
+  /**
+   * Concatenates the given string view with this.
+   * @param rhs A string view to concatenate with.
+   * @return this.
+   */
+  vl_string &operator+= (std::string_view rhs) noexcept (false)
+  {
+    return append (rhs);
   }
 
   /**
@@ -120,22 +352,85 @@ class vl_string : public vl_vector<char, StaticCapacity> {
   vl_string operator+ (const char *rhs) const noexcept (false)
   {
     vl_string res (*this);
-    res.insert (res.data() + res.size(), rhs, rhs + strlen (rhs));
+    res.append (rhs, strlen (rhs));
     return res;
   }
 
   /**
-   * Concatenates the given vl_string object with this.
+   * Concatenates the given vl_string object, of any static capacity, with
+   * this.
    * @param rhs A vl_string object to concatenate with.
    * @return A new vl_string object with the concatenation.
    */
-  vl_string operator+ (const vl_string &rhs) const noexcept (false)
+  template<const size_t M>
+  vl_string operator+ (const vl_string<M> &rhs) const noexcept (false)
   {
     vl_string res (*this);
-    res.insert (res.data() + res.size(), rhs.cbegin (), rhs.cend);
+    res.append (rhs);
     return res;
   }
 
+  /**
+   * @param rhs Another vl_string object, of any static capacity, to compare
+   *            with.
+   * @return true if this and rhs hold the same characters, otherwise false.
+   */
+  template<const size_t M>
+  bool operator== (const vl_string<M> &rhs) const noexcept (true)
+  {
+    return std::string_view (*this) == std::string_view (rhs);
+  }
+
+  /**
+   * @param rhs A string view to compare with.
+   * @return true if this and rhs hold the same characters, otherwise false.
+   */
+  bool operator== (std::string_view rhs) const noexcept (true)
+  {
+    return std::string_view (*this) == rhs;
+  }
+
+  /**
+   * @param rhs A string to compare with.
+   * @return true if this and rhs hold the same characters, otherwise false.
+   */
+  bool operator== (const char *rhs) const noexcept (true)
+  {
+    return std::string_view (*this) == rhs;
+  }
+
+  /**
+   * @param rhs Another vl_string object, of any static capacity, to compare
+   *            with.
+   * @return true if this and rhs do not hold the same characters,
+   *         otherwise false.
+   */
+  template<const size_t M>
+  bool operator!= (const vl_string<M> &rhs) const noexcept (true)
+  {
+    return !(*this == rhs);
+  }
+
+  /**
+   * @param rhs A string view to compare with.
+   * @return true if this and rhs do not hold the same characters,
+   *         otherwise false.
+   */
+  bool operator!= (std::string_view rhs) const noexcept (true)
+  {
+    return !(*this == rhs);
+  }
+
+  /**
+   * @param rhs A string to compare with.
+   * @return true if this and rhs do not hold the same characters,
+   *         otherwise false.
+   */
+  bool operator!= (const char *rhs) const noexcept (true)
+  {
+    return !(*this == rhs);
+  }
+
   /**
    * Enables implicit casting from this to const char *.
    * @return
@@ -145,6 +440,88 @@ class vl_string : public vl_vector<char, StaticCapacity> {
     return this->data ();
   }
 
+  /**
+   * Enables implicit casting from this to std::string_view, which keeps
+   * the length and excludes the '\0' terminator.
+   * @return a string view over the characters of this.
+   */
+  operator std::string_view () const noexcept (true)
+  {
+    return std::string_view (this->data (), size ());
+  }
+
+#if __cplusplus >= 202002L
+  /**
+   * Enables implicit casting from this to std::span<char>, without the
+   * '\0' terminator.
+   * @return a span over the characters of this.
+   */
+  operator std::span<char> () noexcept (true)
+  {
+    return std::span<char> (this->data (), size ());
+  }
+
+  /**
+   * Enables implicit casting from this to std::span<const char>, without
+   * the '\0' terminator.
+   * @return a span over the characters of this.
+   */
+  operator std::span<const char> () const noexcept (true)
+  {
+    return std::span<const char> (this->data (), size ());
+  }
+#endif
+
 };
 
+/**
+ * @param lhs A string view to compare with.
+ * @param rhs A vl_string object to compare with.
+ * @return true if lhs and rhs hold the same characters, otherwise false.
+ */
+template<const size_t StaticCapacity>
+bool operator== (std::string_view lhs, const vl_string<StaticCapacity> &rhs)
+noexcept (true)
+{
+  return rhs == lhs;
+}
+
+/**
+ * @param lhs A string view to compare with.
+ * @param rhs A vl_string object to compare with.
+ * @return true if lhs and rhs do not hold the same characters,
+ *         otherwise false.
+ */
+template<const size_t StaticCapacity>
+bool operator!= (std::string_view lhs, const vl_string<StaticCapacity> &rhs)
+noexcept (true)
+{
+  return rhs != lhs;
+}
+
+/**
+ * @param lhs A string to compare with.
+ * @param rhs A vl_string object to compare with.
+ * @return true if lhs and rhs hold the same characters, otherwise false.
+ */
+template<const size_t StaticCapacity>
+bool operator== (const char *lhs, const vl_string<StaticCapacity> &rhs)
+noexcept (true)
+{
+  return rhs == lhs;
+}
+
+/**
+ * @param lhs A string to compare with.
+ * @param rhs A vl_string object to compare with.
+ * @return true if lhs and rhs do not hold the same characters,
+ *         otherwise false.
+ */
+template<const size_t StaticCapacity>
+bool operator!= (const char *lhs, const vl_string<StaticCapacity> &rhs)
+noexcept (true)
+{
+  return rhs != lhs;
+}
+
 #endif //_VL_STRING_H_
@@ -0,0 +1,143 @@
+#ifndef _VL_STRING_BUILDER_H_
+#define _VL_STRING_BUILDER_H_
+
+#include "vl_string.h"
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Builds a vl_string out of many small pieces. The characters are kept in
+ * a vl_vector<char> without a '\0' terminator, which is added only once by
+ * finish(), that hands the buffer off to a vl_string by move.
+ * @tparam StaticCapacity A value that determines how much characters can be
+ *                        on the stack. Beyond this value, they will be on
+ *                        the heap.
+ */
+template<const size_t StaticCapacity = vl_budget_capacity<char>>
+class vl_string_builder {
+ private:
+  /************* Private Fields **************/
+  vl_vector<char, StaticCapacity> _chars; // the characters built so far.
+
+ public:
+  /************* Methods **************/
+
+  /**
+   * @return the current amount of characters in the builder.
+   */
+  size_t size () const noexcept (true)
+  {
+    return _chars.size ();
+  }
+
+  /**
+   * @return true if the builder is empty, otherwise false.
+   */
+  bool empty () const noexcept (true)
+  {
+    return _chars.empty ();
+  }
+
+  /**
+   * Appends the first 'len' characters of the given string.
+   * @param str A pointer to the characters to append.
+   * @param len Number of characters to append.
+   * @return this.
+   */
+  vl_string_builder &append (const char *str, const size_t len)
+  noexcept (false)
+  {
+    _chars.insert (_chars.end (), str, str + len);
+    return *this;
+  }
+
+  /**
+   * Terminates the built characters and moves them into a vl_string.
+   * The builder is left empty.
+   * @return A vl_string that holds the built characters.
+   */
+  vl_string<StaticCapacity> finish () noexcept (false)
+  {
+    return vl_string<StaticCapacity> (std::move (_chars));
+  }
+
+  /************* Operators Overloading **************/
+
+  /**
+   * @param c A character to append.
+   * @return this.
+   */
+  vl_string_builder &operator<< (const char c) noexcept (false)
+  {
+    _chars.push_back (c);
+    return *this;
+  }
+
+  /**
+   * @param str A string to append.
+   * @return this.
+   */
+  vl_string_builder &operator<< (const char *str) noexcept (false)
+  {
+    return append (str, strlen (str));
+  }
+
+  /**
+   * @param sv A string view to append.
+   * @return this.
+   */
+  vl_string_builder &operator<< (std::string_view sv) noexcept (false)
+  {
+    return append (sv.data (), sv.size ());
+  }
+
+  /**
+   * @tparam Capacity The static capacity of the given vl_string.
+   * @param str A vl_string object to append.
+   * @return this.
+   */
+  template<const size_t Capacity>
+  vl_string_builder &operator<< (const vl_string<Capacity> &str)
+  noexcept (false)
+  {
+    return append (str.data (), str.size ());
+  }
+
+  /**
+   * @param b A boolean to append as "true" or "false".
+   * @return this.
+   */
+  vl_string_builder &operator<< (const bool b) noexcept (false)
+  {
+    return b ? append ("true", 4) : append ("false", 5);
+  }
+
+  /**
+   * @tparam Int An integral type.
+   * @param n An integer to append in decimal.
+   * @return this.
+   */
+  template<typename Int, typename std::enable_if<
+      std::is_integral<Int>::value, int>::type = 0>
+  vl_string_builder &operator<< (const Int n) noexcept (false)
+  {
+    char buf[MAX_NUMBER_CHARS];
+    return append (buf, vl_format_number (buf, n));
+  }
+
+  /**
+   * @tparam Float A floating point type.
+   * @param n A number to append in its shortest round-trip form.
+   * @return this.
+   */
+  template<typename Float, typename std::enable_if<
+      std::is_floating_point<Float>::value, int>::type = 0>
+  vl_string_builder &operator<< (const Float n) noexcept (false)
+  {
+    char buf[MAX_NUMBER_CHARS];
+    return append (buf, vl_format_number (buf, n));
+  }
+
+};
+
+#endif //_VL_STRING_BUILDER_H_
@@ -0,0 +1,274 @@
+#ifndef _VL_THREAD_POOL_H_
+#define _VL_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// workers of the process wide pool, 0 for one per hardware thread.
+#ifndef PARALLEL_THREADS
+#define PARALLEL_THREADS 0
+#endif
+
+/**
+ * A small work-stealing thread pool. Every worker has its own queue of
+ * tasks: submitted tasks are spread between the queues, a worker takes the
+ * newest task from its own queue, and steals the oldest task from another
+ * queue when its own is empty.
+ */
+class vl_thread_pool {
+ private:
+  /************* Private Types **************/
+
+  /**
+   * The queue of tasks of a single worker.
+   */
+  struct worker_queue {
+    std::mutex lock; // guards tasks.
+    std::deque<std::function<void ()>> tasks; // the queued tasks.
+  };
+
+  /************* Private Fields **************/
+  size_t _size; // number of workers.
+  std::unique_ptr<worker_queue[]> _queues; // a queue for every worker.
+  std::unique_ptr<std::thread[]> _threads; // the workers.
+  std::atomic<long> _queued; // number of queued tasks, may be off briefly.
+  std::atomic<size_t> _next; // the queue the next task is submitted to.
+  std::mutex _sleep_lock; // guards _stop and the sleeping of the workers.
+  std::condition_variable _wake; // wakes sleeping workers.
+  bool _stop; // true when the workers should exit.
+
+  /************* Private Methods **************/
+
+  /**
+   * Takes a task, from the back of the home queue or else from the front of
+   * any other queue.
+   * @param home The index of the queue to look at first.
+   * @param task Gets the task that was taken.
+   * @return true if a task was taken, otherwise false.
+   */
+  bool pop (const size_t home, std::function<void ()> &task) noexcept (false)
+  {
+    for (size_t i = 0; i < _size; ++i)
+      {
+        worker_queue &queue = _queues[(home + i) % _size];
+        std::lock_guard<std::mutex> guard (queue.lock);
+        if (queue.tasks.empty ())
+          {
+            continue;
+          }
+        if (i == 0)
+          {
+            task = std::move (queue.tasks.back ());
+            queue.tasks.pop_back ();
+          }
+        else
+          {
+            task = std::move (queue.tasks.front ());
+            queue.tasks.pop_front ();
+          }
+        --_queued;
+        return true;
+      }
+    return false;
+  }
+
+  /**
+   * The loop of a worker, which runs tasks until the pool is destroyed.
+   * @param home The index of the queue of the worker.
+   */
+  void work (const size_t home) noexcept (false)
+  {
+    std::function<void ()> task;
+    while (true)
+      {
+        if (pop (home, task))
+          {
+            task ();
+            continue;
+          }
+        std::unique_lock<std::mutex> guard (_sleep_lock);
+        _wake.wait (guard, [this] { return _stop || _queued > 0; });
+        if (_stop && _queued <= 0)
+          {
+            return;
+          }
+      }
+  }
+
+  /**
+   * Tells the workers to exit once the queues are empty, and joins the
+   * ones that were started.
+   */
+  void stop () noexcept (false)
+  {
+    {
+      std::lock_guard<std::mutex> guard (_sleep_lock);
+      _stop = true;
+    }
+    _wake.notify_all ();
+    for (size_t i = 0; i < _size; ++i)
+      {
+        if (_threads[i].joinable ())
+          {
+            _threads[i].join ();
+          }
+      }
+  }
+
+  /**
+   * Runs queued tasks on the calling thread until 'remaining' drops to 0.
+   * @param remaining Number of tasks that didn't finish yet.
+   */
+  void wait (const std::atomic<size_t> &remaining) noexcept (false)
+  {
+    while (remaining > 0)
+      {
+        if (!run_one ())
+          {
+            std::this_thread::yield ();
+          }
+      }
+  }
+
+ public:
+  /************* Constructors & Destructor **************/
+
+  /**
+   * Starts the workers.
+   * @param threads Number of workers, at least 1.
+   */
+  explicit vl_thread_pool (const size_t threads) :
+      _size (std::max (threads, (size_t) 1)),
+      _queues (new worker_queue[_size]),
+      _threads (new std::thread[_size]),
+      _queued (0),
+      _next (0),
+      _stop (false)
+  {
+    try
+      {
+        for (size_t i = 0; i < _size; ++i)
+          {
+            _threads[i] = std::thread (&vl_thread_pool::work, this, i);
+          }
+      }
+    catch (...)
+      {
+        // destroying a thread that wasn't joined terminates the program.
+        stop ();
+        throw;
+      }
+  }
+
+  vl_thread_pool (const vl_thread_pool &) = delete;
+  vl_thread_pool &operator= (const vl_thread_pool &) = delete;
+
+  /**
+   * Runs the queued tasks, and stops the workers.
+   */
+  ~vl_thread_pool ()
+  {
+    stop ();
+  }
+
+  /************* Methods **************/
+
+  /**
+   * @return the process wide pool, with PARALLEL_THREADS workers.
+   */
+  static vl_thread_pool &instance () noexcept (false)
+  {
+    static vl_thread_pool pool (PARALLEL_THREADS != 0 ? PARALLEL_THREADS :
+                                std::thread::hardware_concurrency ());
+    return pool;
+  }
+
+  /**
+   * @return the number of workers.
+   */
+  size_t size () const noexcept (true)
+  {
+    return _size;
+  }
+
+  /**
+   * Queues a task to be run by one of the workers.
+   * @param task A task, which must not throw.
+   */
+  void submit (std::function<void ()> task) noexcept (false)
+  {
+    worker_queue &queue = _queues[_next++ % _size];
+    {
+      std::lock_guard<std::mutex> guard (queue.lock);
+      queue.tasks.push_back (std::move (task));
+    }
+    {
+      std::lock_guard<std::mutex> guard (_sleep_lock);
+      ++_queued;
+    }
+    _wake.notify_one ();
+  }
+
+  /**
+   * Runs one queued task on the calling thread, which lets a thread that
+   * waits for tasks help with them instead of blocking.
+   * @return true if a task was run, otherwise false.
+   */
+  bool run_one () noexcept (false)
+  {
+    std::function<void ()> task;
+    if (!pop (_next % _size, task))
+      {
+        return false;
+      }
+    task ();
+    return true;
+  }
+
+  /**
+   * Runs fn (i) for every i in [0, count) on the workers, and waits for all
+   * of them. The calling thread runs fn (0) and helps with queued tasks, so
+   * a task may call run itself. If a task can't be queued, the queued ones
+   * are waited for before the exception propagates, since they refer to fn.
+   * @tparam Fn A callable that takes a task index, and must not throw.
+   * @param count Number of tasks.
+   * @param fn The function to run.
+   */
+  template<typename Fn>
+  void run (const size_t count, const Fn &fn) noexcept (false)
+  {
+    if (count == 0)
+      {
+        return;
+      }
+    std::atomic<size_t> remaining (0);
+    try
+      {
+        for (size_t i = 1; i < count; ++i)
+          {
+            ++remaining;
+            submit ([&fn, &remaining, i] {
+              fn (i);
+              --remaining;
+            });
+          }
+      }
+    catch (...)
+      {
+        --remaining; // the task that wasn't queued.
+        wait (remaining);
+        throw;
+      }
+    fn ((size_t) 0);
+    wait (remaining);
+  }
+};
+
+#endif //_VL_THREAD_POOL_H_
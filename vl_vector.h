@@ -1,101 +1,245 @@
 #ifndef _VL_VECTOR_H_
 #define _VL_VECTOR_H_
 
+#include "vl_memory.h"
+#include "vl_sort.h"
 #include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
 #include <stdexcept>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 
 #define DEFAULT_STATIC_CAPACITY 16
 #define GROWTH_FACTOR 1.5
+#define CACHE_LINE_SIZE 64
+#define DEFAULT_STATIC_BYTES (2 * CACHE_LINE_SIZE)
 
 /**
- * Represents a Variable Length Vector which uses the static memory (Stack)
- * as long as it's size is below or equal to static_cap, otherwise
- * it will use the dynamic memory (Heap).
+ * @tparam T The type of the elements.
+ * @return the maximal amount of elements of type T a vector can hold, such
+ *         that their size in bytes and the distance between them can't
+ *         overflow.
+ */
+template<typename T>
+constexpr size_t vl_max_size () noexcept (true)
+{
+  return (size_t) std::numeric_limits<std::ptrdiff_t>::max () / sizeof (T);
+}
+
+/**
+ * The heap capacity a vector should get to hold 'size' elements and 'k'
+ * more, limited by max. Throws std::length_error if they don't fit in max.
+ * @param size Number of elements a vector contains.
+ * @param k Number of elements we want to add to a vector.
+ * @param max The maximal capacity.
+ * @return GROWTH_FACTOR times the amount of elements, or max.
+ */
+inline size_t vl_grow_capacity (const size_t &size, const size_t &k,
+                                const size_t &max) noexcept (false)
+{
+  if (size > max || k > max - size)
+    {
+      throw std::length_error{"Capacity exceeds max_size"};
+    }
+  const size_t n = size + k;
+  if (n > max / GROWTH_FACTOR)
+    {
+      return max;
+    }
+  // max / GROWTH_FACTOR is rounded as a double, so the product may still
+  // pass max by a little.
+  return std::min ((size_t) (GROWTH_FACTOR * n), max);
+}
+
+/**
+ * Finds out if a range that is inserted into a vector is a part of that
+ * vector, like the element of v.push_back (v[0]). Growing or shifting the
+ * data moves such a range, so it's then read by its index.
+ * @tparam T The type of the elements.
+ * @tparam ForwardIterator The type of iterator of the range.
+ * @param data The data of the vector.
+ * @param size Number of elements in the vector.
+ * @param first An iterator to the first element of the range.
+ * @return The index of the range in the data, or size if it isn't a part
+ *         of it.
+ */
+template<typename T, class ForwardIterator>
+size_t vl_alias_index (const T *data, const size_t size,
+                       ForwardIterator first) noexcept (true)
+{
+  if constexpr (std::is_convertible<ForwardIterator, const T *>::value)
+    {
+      const T *src = first;
+      std::less<const T *> less;
+      if (!less (src, data) && less (src, data + size))
+        {
+          return src - data;
+        }
+    }
+  else
+    {
+      (void) data;
+      (void) first;
+    }
+  return size;
+}
+
+/**
+ * Copies k elements of the data, that were at index 'from' before the
+ * elements from index onwards were moved k places forward, to the k places
+ * at index. No place is written before it's read.
+ * @tparam T The type of the elements.
+ * @param data The data of a vector.
+ * @param index Where the elements are copied to.
+ * @param from Where the elements were.
+ * @param k Number of elements.
+ */
+template<typename T>
+void vl_copy_shifted (T *data, const size_t index, size_t from,
+                      const size_t k) noexcept (false)
+{
+  for (size_t j = 0; j < k; ++j, ++from)
+    {
+      data[index + j] = data[(from < index) ? from : from + k];
+    }
+}
+
+/**
+ * The part of a vl_vector that does not depend on its static capacity.
+ * All the algorithms live here, so they are instantiated once per element
+ * type instead of once per capacity, and functions can take any vl_vector
+ * of T as a vl_vector_ref<T> & without being templated on the capacity.
+ * It has no storage of its own, so it can't be created directly.
  * @tparam T The type of the elements that the vector will operate on.
- * @tparam static_cap A value that determines how much elements can be on
- *                    the stack. Beyond this value, they will be on the heap.
  */
-template<typename T, const int StaticCapacity = DEFAULT_STATIC_CAPACITY>
-class vl_vector {
+template<typename T>
+class vl_vector_ref {
  protected:
   /************* Protected Fields **************/
-  T _stack_data[StaticCapacity]; // holds the data in the stack memory.
+  T *_stack_data; // points at the stack memory of the derived vl_vector.
   T *_heap_data; // holds the data in the heap memory.
   size_t _size; // size of this vector.
   size_t _cap; // capacity of this vector.
+  size_t _static_cap; // how much elements can be on the stack.
 
- public:
-  /************* Constructors & Destructor **************/
+  /************* Protected Constructors **************/
 
   /**
-   * Default constructor which initializes empty vl_vector.
+   * Initializes an empty vector which uses the given stack memory.
+   * @param stack_data The stack memory of the derived vl_vector.
+   * @param static_cap How much elements fit in stack_data.
    */
-  vl_vector () :
+  vl_vector_ref (T *stack_data, const size_t static_cap) :
+      _stack_data (stack_data),
       _heap_data (nullptr),
       _size (0),
-      _cap (StaticCapacity)
+      _cap (static_cap),
+      _static_cap (static_cap)
   {}
 
   /**
-   * Copy Constructor.
-   * @param vlv A vl_vector object to copy from.
+   * The derived vl_vector knows its alignment at compile time, so it isn't
+   * stored in every vector. The derived vl_vector frees its heap memory in
+   * its own destructor, while this still returns its alignment.
+   * @return the alignment of the stack memory, which heap memory gets as
+   *         well.
    */
-  vl_vector (const vl_vector &vlv) :
-      _heap_data (nullptr),
-      _size (vlv._size),
-      _cap (vlv._cap)
+  virtual size_t alignment () const noexcept (true)
   {
-    if (vlv._cap == StaticCapacity)
-      {
-        std::copy (vlv._stack_data, vlv._stack_data + size (), _stack_data);
-      }
-    else
-      {
-        _heap_data = new T[_cap];
-        std::copy (vlv._heap_data, vlv._heap_data + size (), _heap_data);
-      }
+    return alignof (T);
   }
 
   /**
-   * Sequence based constructor. Gets a range of elements - [first, last),
-   * and stores them in the vector.
-   * @tparam ForwardIterator the type of iterator.
-   * @param first An iterator that represents the first element.
-   * @param last An iterator that represents the last element.
+   * @param n Number of elements.
+   * @return A pointer to new heap memory for n elements, with the
+   *         alignment of this vector.
    */
-  template<class ForwardIterator>
-  vl_vector (ForwardIterator first, ForwardIterator last) : vl_vector ()
+  T *allocate (const size_t n) const noexcept (false)
   {
-    insert (_stack_data, first, last);
+    return vl_allocate<T> (n, alignment ());
   }
 
   /**
-   * Single value initialized constructor. Initializes the vector with
-   * 'count' number of elements that has the value 'v'.
+   * Frees the heap memory, if there is any. The capacity must still be the
+   * one it was allocated with.
+   */
+  void free_heap () noexcept (true)
+  {
+    vl_deallocate (_heap_data, _cap, alignment ());
+    _heap_data = nullptr;
+  }
+
+  /**
+   * Tries to grow the heap memory to new_cap elements by remapping its
+   * pages instead of copying them (see vl_try_reallocate).
+   * @param new_cap The new capacity, larger than the current one.
+   * @return true if the heap memory was grown, otherwise false.
+   */
+  bool grow_heap (const size_t new_cap) noexcept (true)
+  {
+    if (_heap_data == nullptr)
+      {
+        return false;
+      }
+    T *grown = vl_try_reallocate (_heap_data, _cap, new_cap, alignment ());
+    if (grown == nullptr)
+      {
+        return false;
+      }
+    _heap_data = grown;
+    _cap = new_cap;
+    return true;
+  }
+
+  /**
+   * Initializes the vector with 'count' number of elements that has the
+   * value 'v'. The vector must be empty.
    * @param count Number of elements to initialize.
    * @param v The value to initalize with.
    */
-  vl_vector (const size_t &count, const T &v) : vl_vector ()
+  void fill_init (const size_t &count, const T &v) noexcept (false)
   {
-    if (count <= StaticCapacity)
+    if (count > _static_cap)
       {
-        std::fill_n (_stack_data, count, v);
+        _cap = cap_c (_size, count);
+        _heap_data = allocate (_cap);
       }
-    else
+    // fresh huge page memory is already zero, so its pages stay untouched.
+    if (_heap_data == nullptr || !vl_is_zeroed<T> (_cap) || !vl_is_zero (v))
       {
-        _cap = cap_c (_size, count);
-        _heap_data = new T[_cap];
-        std::fill_n (_heap_data, count, v);
+        vl_bulk_fill (data (), count, v);
       }
     _size += count;
   }
 
+  /**
+   * Frees the heap memory, if there is any, and leaves the vector empty
+   * on the stack.
+   */
+  void release () noexcept (true)
+  {
+    free_heap ();
+    _size = 0;
+    _cap = _static_cap;
+  }
+
+ public:
+  /************* Destructor **************/
+
+  /**
+   * A vl_vector_ref has no storage of its own, so it can't be copied.
+   */
+  vl_vector_ref (const vl_vector_ref &) = delete;
+
   /**
    * Destructor.
    */
-  virtual ~vl_vector ()
+  virtual ~vl_vector_ref ()
   {
-    delete[] _heap_data;
+    free_heap ();
   }
 
   /************* Iterator, Reverse Iterator and their Const **************/
@@ -202,7 +346,7 @@ class vl_vector {
     return const_reverse_iterator (data ());
   }
 
- private:
+ protected:
   /************* Protected Methods **************/
 
   /**
@@ -212,10 +356,10 @@ class vl_vector {
    * @param k Number of elements we want to add to a vector.
    * @return The maximal amount of elements a vector can contain.
    */
-  static size_t cap_c (const size_t &size, const size_t &k) noexcept (true)
+  size_t cap_c (const size_t &size, const size_t &k) const noexcept (false)
   {
-    return (size + k <= StaticCapacity) ?
-           StaticCapacity : (int) (GROWTH_FACTOR * (size + k));
+    return (size + k <= _static_cap && k <= _static_cap) ?
+           _static_cap : vl_grow_capacity (size, k, max_size ());
   }
 
  public:
@@ -227,7 +371,7 @@ class vl_vector {
    */
   T *data () noexcept (true)
   {
-    return (_cap == StaticCapacity) ? _stack_data : _heap_data;
+    return (_cap == _static_cap) ? _stack_data : _heap_data;
   }
 
   /**
@@ -236,7 +380,7 @@ class vl_vector {
    */
   const T *data () const noexcept (true)
   {
-    return (_cap == StaticCapacity) ? _stack_data : _heap_data;
+    return (_cap == _static_cap) ? _stack_data : _heap_data;
   }
 
   /**
@@ -249,6 +393,18 @@ class vl_vector {
     return !(result == data () + _size);
   }
 
+  /**
+   * Searches the elements, which must be in ascending order, without
+   * branches (see vl_branchless_lower_bound).
+   * @param value A value to search for.
+   * @return an iterator to the first element that isn't less than value,
+   *         or end () if there is none.
+   */
+  const_iterator lower_bound (const T &value) const noexcept (false)
+  {
+    return vl_branchless_lower_bound (data (), _size, value);
+  }
+
   /**
    * @return the current amount of elements in the vector.
    */
@@ -265,6 +421,14 @@ class vl_vector {
     return _cap;
   }
 
+  /**
+   * @return the maximal amount of elements the vector can hold.
+   */
+  static constexpr size_t max_size () noexcept (true)
+  {
+    return vl_max_size<T> ();
+  }
+
   /**
    * @return true if the vector is empty, otherwise false.
    */
@@ -273,6 +437,41 @@ class vl_vector {
     return size () == 0;
   }
 
+  /**
+   * Makes sure the vector can hold at least n elements without another
+   * allocation. Does nothing if the capacity is already large enough.
+   * @param n The requested capacity.
+   */
+  void reserve (const size_t n) noexcept (false)
+  {
+    if (n <= _cap || grow_heap (n))
+      {
+        return;
+      }
+    if (n > max_size ())
+      {
+        throw std::length_error{"Capacity exceeds max_size"};
+      }
+    T *temp = allocate (n);
+    std::move (data (), data () + _size, temp);
+    free_heap ();
+    _heap_data = temp;
+    _cap = n;
+  }
+
+  /**
+   * Gives the kernel a hint about how the heap memory will be accessed,
+   * for example MADV_SEQUENTIAL before a scan or MADV_WILLNEED before it's
+   * read. Only heap memory of at least HUGE_PAGE_THRESHOLD bytes, which is
+   * mapped on huge pages, takes hints.
+   * @param advice An madvise advice.
+   * @return true if the hint was given, otherwise false.
+   */
+  bool advise (const int advice) const noexcept (true)
+  {
+    return vl_advise (_heap_data, _cap * sizeof (T), advice);
+  }
+
   /**
    * @param i An index.
    * @return A reference to the element at index i in the vector.
@@ -316,30 +515,44 @@ class vl_vector {
   {
     iterator pos = (iterator) position;
     size_t k = last - first; // number of new elements to add
-    if ((_cap == StaticCapacity) && (_size + k > _cap))
+    size_t index = pos - data (); // where pos is, if the data is remapped
+    // where the range is, if it's a part of this vector.
+    const size_t from = vl_alias_index (data (), _size, first);
+    if ((_cap == _static_cap) && (_size + k > _cap))
       {
         _cap = cap_c (_size, k);
-        _heap_data = new T[_cap];
+        _heap_data = allocate (_cap);
         iterator it_1 = std::copy (_stack_data, pos, _heap_data);
         iterator it_2 = std::copy (first, last, it_1);
         std::copy (pos, _stack_data + _size, it_2);
         pos = it_1;
       }
-    else if ((_cap != StaticCapacity) && (_size + k > _cap))
+    else if ((_cap != _static_cap) && (_size + k > _cap)
+             && (from != _size || !grow_heap (cap_c (_size, k))))
       {
-        _cap = cap_c (_size, k);
-        T *temp = new T[_cap];
+        size_t new_cap = cap_c (_size, k);
+        T *temp = allocate (new_cap);
         iterator it_1 = std::copy (_heap_data, pos, temp);
         iterator it_2 = std::copy (first, last, it_1);
         std::copy (pos, _heap_data + _size, it_2);
-        delete[] _heap_data;
+        free_heap ();
         _heap_data = temp;
+        _cap = new_cap;
         pos = it_1;
       }
-    else if (_size + k <= _cap)
+    else
       {
-        std::move (pos, end (), pos + k);
-        std::copy (first, last, pos);
+        // there is room, possibly after grow_heap remapped the data.
+        pos = data () + index;
+        std::move_backward (pos, end (), end () + k);
+        if (from == _size)
+          {
+            std::copy (first, last, pos);
+          }
+        else
+          {
+            vl_copy_shifted (data (), index, from, k);
+          }
       }
     _size += k;
     return pos;
@@ -376,13 +589,12 @@ class vl_vector {
   {
     iterator r_value = (iterator) first;
     size_t k = last - first; // number of elements to delete
-    if ((_cap != StaticCapacity) && (_size - k <= StaticCapacity))
+    if ((_cap != _static_cap) && (_size - k <= _static_cap))
       {
         iterator it_1 = std::copy (_heap_data, (iterator) first, _stack_data);
         std::copy ((iterator) last, end (), it_1);
-        delete[] _heap_data;
-        _heap_data = nullptr;
-        _cap = StaticCapacity;
+        free_heap ();
+        _cap = _static_cap;
         r_value = it_1;
       }
     else
@@ -416,21 +628,55 @@ class vl_vector {
   }
 
   /**
-   * Deletes all elements from the vector.
+   * Changes the number of elements to count, by deleting the last elements
+   * or by adding copies of v at the end. Grows like insert, unless the
+   * capacity was reserved in advance.
+   * @param count The new number of elements.
+   * @param v The value of the added elements.
    */
-  virtual void clear () noexcept (false)
+  void resize (const size_t count, const T &v = T ()) noexcept (false)
   {
-    _size = 0;
-    if (_cap == StaticCapacity)
+    if (count <= _size)
       {
+        erase (data () + count, end ());
         return;
       }
-    else
+    if (count > _cap)
       {
-        delete[] _heap_data;
-        _heap_data = nullptr;
-        _cap = StaticCapacity;
+        reserve (cap_c (_size, count - _size));
       }
+    vl_bulk_fill (data () + _size, count - _size, v);
+    _size = count;
+  }
+
+  /**
+   * Deletes all elements from the vector.
+   */
+  virtual void clear () noexcept (false)
+  {
+    release ();
+  }
+
+  /**
+   * Sorts the elements in ascending order. Integral and floating point
+   * elements are radix sorted (see vl_sort_elements), with the spare
+   * capacity as scratch memory when it's large enough, or sorted by
+   * sorting networks when there are at most SORT_NETWORK_MAX of them.
+   */
+  void sort () noexcept (false)
+  {
+    vl_sort_elements (data (), size (), data () + _size, _cap - _size,
+                      false);
+  }
+
+  /**
+   * Sorts the elements in ascending order, and keeps equal elements in
+   * their order.
+   */
+  void stable_sort () noexcept (false)
+  {
+    vl_sort_elements (data (), size (), data () + _size, _cap - _size,
+                      true);
   }
 
   /************* Operators Overloading **************/
@@ -454,26 +700,56 @@ class vl_vector {
   }
 
   /**
-   * Assignment operator - assigns another vl_vector to this.
-   * @param rhs Another vl_vector object to assign.
+   * Assignment operator - assigns the elements of another vector of any
+   * static capacity to this.
+   * @param rhs Another vector to assign.
    * @return this.
    */
-  vl_vector &operator= (const vl_vector &rhs) noexcept (false)
+  vl_vector_ref &operator= (const vl_vector_ref &rhs) noexcept (false)
+  {
+    if (this != &rhs)
+      {
+        release ();
+        if (rhs._size > _static_cap)
+          {
+            _cap = (rhs._cap != rhs._static_cap) ?
+                   rhs._cap : cap_c (0, rhs._size);
+            _heap_data = allocate (_cap);
+          }
+        vl_bulk_copy (rhs.data (), rhs.data () + rhs._size, data ());
+        _size = rhs._size;
+      }
+    return *this;
+  }
+
+  /**
+   * Move assignment operator - steals the heap memory of another vector of
+   * any static capacity if it has one that doesn't fit on the stack of
+   * this and has the same alignment, otherwise moves its elements.
+   * rhs is left empty.
+   * @param rhs Another vector to move from.
+   * @return this.
+   */
+  vl_vector_ref &operator= (vl_vector_ref &&rhs) noexcept (false)
   {
     if (this != &rhs)
       {
-        this->_size = rhs._size;
-        this->_cap = rhs._cap;
-        delete[] this->_heap_data;
-        if (_cap == StaticCapacity)
+        release ();
+        if (rhs._cap != rhs._static_cap && rhs._cap > _static_cap
+            && rhs.alignment () == alignment ())
           {
-            std::copy (rhs.begin (), rhs.end (), _stack_data);
+            _heap_data = rhs._heap_data;
+            _size = rhs._size;
+            _cap = rhs._cap;
+            rhs._heap_data = nullptr;
           }
         else
           {
-            this->_heap_data = new T[rhs._cap];
-            std::copy (rhs.begin (), rhs.end (), _heap_data);
+            reserve (rhs._size);
+            std::move (rhs.data (), rhs.data () + rhs._size, data ());
+            _size = rhs._size;
           }
+        rhs.release ();
       }
     return *this;
   }
@@ -481,10 +757,10 @@ class vl_vector {
   /**
    * Checks if both object's size and elements are equal, and they appear
    * at the same order.
-   * @param rhs Another vl_vector object to compare with.
+   * @param rhs Another vector to compare with.
    * @return true if this and rhs are equal, otherwise false.
    */
-  bool operator== (const vl_vector &rhs) const noexcept (false)
+  bool operator== (const vl_vector_ref &rhs) const noexcept (false)
   {
     return (this->_size == rhs._size) &&
            std::equal (this->cbegin (), this->cend (), rhs.cbegin ());
@@ -493,14 +769,864 @@ class vl_vector {
   /**
    * Checks if both object's size and elements are equal, and they appear
    * at the same order.
-   * @param rhs Another vl_vector object to compare with.
+   * @param rhs Another vector to compare with.
    * @return true if this and rhs are not equal, otherwise false.
    */
-  bool operator!= (const vl_vector &rhs) const noexcept (false)
+  bool operator!= (const vl_vector_ref &rhs) const noexcept (false)
   {
     return (this->_size != rhs._size) ||
            !std::equal (this->cbegin (), this->cend (), rhs.cbegin ());
   }
 
+#if __cplusplus >= 202002L
+  /**
+   * Enables implicit casting from this to std::span<T>.
+   * @return a span over the elements of this.
+   */
+  operator std::span<T> () noexcept (true)
+  {
+    return std::span<T> (data (), _size);
+  }
+
+  /**
+   * Enables implicit casting from this to std::span<const T>.
+   * @return a span over the elements of this.
+   */
+  operator std::span<const T> () const noexcept (true)
+  {
+    return std::span<const T> (data (), _size);
+  }
+#endif
+
+};
+
+/**
+ * How much elements of type T fit on the stack of a vl_vector whose whole
+ * object takes at most Bytes bytes. It's at least 1 even when not one
+ * element fits, since a capacity of 0 makes the vl_vector a plain heap
+ * vector, which isn't a vl_vector_ref<T>; that one is asked for explicitly.
+ * @tparam T The type of the elements.
+ * @tparam Bytes The size budget of the whole vl_vector object.
+ */
+template<typename T, const size_t Bytes = DEFAULT_STATIC_BYTES>
+constexpr size_t vl_budget_capacity =
+    (Bytes >= sizeof (vl_vector_ref<T>) + sizeof (T)) ?
+    (Bytes - sizeof (vl_vector_ref<T>)) / sizeof (T) : 1;
+
+/**
+ * Represents a Variable Length Vector which uses the static memory (Stack)
+ * as long as it's size is below or equal to static_cap, otherwise
+ * it will use the dynamic memory (Heap).
+ * @tparam T The type of the elements that the vector will operate on.
+ * @tparam static_cap A value that determines how much elements can be on
+ *                    the stack. Beyond this value, they will be on the heap.
+ *                    By default as much as fit in DEFAULT_STATIC_BYTES.
+ * @tparam Alignment The alignment of the data, on the stack and on the heap.
+ *                   Can be raised above alignof (T), for example to
+ *                   CACHE_LINE_SIZE for aligned SIMD loads.
+ */
+template<typename T, const size_t StaticCapacity = vl_budget_capacity<T>,
+    const size_t Alignment = alignof (T)>
+class vl_vector : public vl_vector_ref<T> {
+  static_assert (Alignment >= alignof (T) &&
+                 (Alignment & (Alignment - 1)) == 0,
+                 "Alignment must be a power of 2 and at least alignof (T)");
+
+ protected:
+  /************* Protected Fields **************/
+  // holds the data in the stack memory.
+  alignas (Alignment) T _stack_storage[StaticCapacity];
+
+  /************* Protected Methods **************/
+
+  /**
+   * @return the alignment of the stack and heap memory.
+   */
+  size_t alignment () const noexcept (true) override
+  {
+    return Alignment;
+  }
+
+ public:
+  /************* Constructors & Destructor **************/
+
+  /**
+   * Default constructor which initializes empty vl_vector.
+   */
+  vl_vector () : vl_vector_ref<T> (_stack_storage, StaticCapacity)
+  {}
+
+  /**
+   * Copy Constructor.
+   * @param vlv A vl_vector object to copy from.
+   */
+  vl_vector (const vl_vector &vlv) : vl_vector ()
+  {
+    vl_vector_ref<T>::operator= (vlv);
+  }
+
+  /**
+   * Move Constructor. Steals the heap buffer of vlv if it has one, and
+   * leaves vlv empty.
+   * @param vlv A vl_vector object to move from.
+   */
+  vl_vector (vl_vector &&vlv) noexcept (true) : vl_vector ()
+  {
+    vl_vector_ref<T>::operator= (std::move (vlv));
+  }
+
+  /**
+   * Sequence based constructor. Gets a range of elements - [first, last),
+   * and stores them in the vector.
+   * @tparam ForwardIterator the type of iterator.
+   * @param first An iterator that represents the first element.
+   * @param last An iterator that represents the last element.
+   */
+  template<class ForwardIterator>
+  vl_vector (ForwardIterator first, ForwardIterator last) : vl_vector ()
+  {
+    this->insert (this->begin (), first, last);
+  }
+
+#if __cplusplus >= 202002L
+  /**
+   * Span based constructor. Copies the elements the span refers to.
+   * @param elements A span of elements to store.
+   */
+  explicit vl_vector (std::span<const T> elements) :
+      vl_vector (elements.data (), elements.data () + elements.size ())
+  {}
+#endif
+
+  /**
+   * Single value initialized constructor. Initializes the vector with
+   * 'count' number of elements that has the value 'v'.
+   * @param count Number of elements to initialize.
+   * @param v The value to initalize with.
+   */
+  vl_vector (const size_t &count, const T &v) : vl_vector ()
+  {
+    this->fill_init (count, v);
+  }
+
+  /**
+   * Value initialized constructor. Initializes the vector with 'count'
+   * number of value initialized elements.
+   * @param count Number of elements to initialize.
+   */
+  explicit vl_vector (const size_t &count) : vl_vector (count, T ())
+  {}
+
+  /**
+   * Destructor. Frees the heap memory here, since the destructor of
+   * vl_vector_ref no longer sees the alignment it was allocated with.
+   */
+  ~vl_vector () override
+  {
+    this->free_heap ();
+  }
+
+  /************* Operators Overloading **************/
+
+  // allows assigning vectors of other static capacities.
+  using vl_vector_ref<T>::operator=;
+
+  /**
+   * Assignment operator - assigns another vl_vector to this.
+   * @param rhs Another vl_vector object to assign.
+   * @return this.
+   */
+  vl_vector &operator= (const vl_vector &rhs) noexcept (false)
+  {
+    vl_vector_ref<T>::operator= (rhs);
+    return *this;
+  }
+
+  /**
+   * Move assignment operator - steals the data of another vl_vector and
+   * leaves it empty.
+   * @param rhs Another vl_vector object to move from.
+   * @return this.
+   */
+  vl_vector &operator= (vl_vector &&rhs) noexcept (true)
+  {
+    vl_vector_ref<T>::operator= (std::move (rhs));
+    return *this;
+  }
+
+};
+
+/**
+ * A vl_vector whose static capacity is derived from a size budget for the
+ * whole object, rather than given as an amount of elements.
+ * @tparam T The type of the elements that the vector will operate on.
+ * @tparam Bytes The size budget of the whole vl_vector object.
+ */
+template<typename T, const size_t Bytes = DEFAULT_STATIC_BYTES>
+using vl_budget_vector = vl_vector<T, vl_budget_capacity<T, Bytes>>;
+
+/**
+ * A vl_vector without static memory, which is a plain dynamic array: it
+ * keeps its elements on the heap only, and holds just a pointer, a size and
+ * a capacity, so none of its methods need to check where the data is.
+ * Unlike other vl_vectors it isn't a vl_vector_ref.
+ * @tparam T The type of the elements that the vector will operate on.
+ * @tparam Alignment The alignment of the data on the heap.
+ */
+template<typename T, const size_t Alignment>
+class vl_vector<T, 0, Alignment> {
+  static_assert (Alignment >= alignof (T) &&
+                 (Alignment & (Alignment - 1)) == 0,
+                 "Alignment must be a power of 2 and at least alignof (T)");
+
+ protected:
+  /************* Protected Fields **************/
+  T *_heap_data; // holds the data in the heap memory.
+  size_t _size; // size of this vector.
+  size_t _cap; // capacity of this vector.
+
+ public:
+  /************* Constructors & Destructor **************/
+
+  /**
+   * Default constructor which initializes empty vl_vector.
+   */
+  vl_vector () :
+      _heap_data (nullptr),
+      _size (0),
+      _cap (0)
+  {}
+
+  /**
+   * Copy Constructor.
+   * @param vlv A vl_vector object to copy from.
+   */
+  vl_vector (const vl_vector &vlv) :
+      _heap_data (nullptr),
+      _size (vlv._size),
+      _cap (vlv._cap)
+  {
+    if (_cap != 0)
+      {
+        _heap_data = vl_allocate<T> (_cap, Alignment);
+        vl_bulk_copy (vlv.begin (), vlv.end (), _heap_data);
+      }
+  }
+
+  /**
+   * Move Constructor. Steals the heap buffer of vlv and leaves it empty.
+   * @param vlv A vl_vector object to move from.
+   */
+  vl_vector (vl_vector &&vlv) noexcept (true) :
+      _heap_data (vlv._heap_data),
+      _size (vlv._size),
+      _cap (vlv._cap)
+  {
+    vlv._heap_data = nullptr;
+    vlv._size = 0;
+    vlv._cap = 0;
+  }
+
+  /**
+   * Sequence based constructor. Gets a range of elements - [first, last),
+   * and stores them in the vector.
+   * @tparam ForwardIterator the type of iterator.
+   * @param first An iterator that represents the first element.
+   * @param last An iterator that represents the last element.
+   */
+  template<class ForwardIterator>
+  vl_vector (ForwardIterator first, ForwardIterator last) : vl_vector ()
+  {
+    insert (begin (), first, last);
+  }
+
+#if __cplusplus >= 202002L
+  /**
+   * Span based constructor. Copies the elements the span refers to.
+   * @param elements A span of elements to store.
+   */
+  explicit vl_vector (std::span<const T> elements) :
+      vl_vector (elements.data (), elements.data () + elements.size ())
+  {}
+#endif
+
+  /**
+   * Single value initialized constructor. Initializes the vector with
+   * 'count' number of elements that has the value 'v'.
+   * @param count Number of elements to initialize.
+   * @param v The value to initalize with.
+   */
+  vl_vector (const size_t &count, const T &v) : vl_vector ()
+  {
+    if (count != 0)
+      {
+        _cap = cap_c (0, count);
+        _heap_data = vl_allocate<T> (_cap, Alignment);
+        // fresh huge page memory is already zero, so its pages stay
+        // untouched.
+        if (!vl_is_zeroed<T> (_cap) || !vl_is_zero (v))
+          {
+            vl_bulk_fill (_heap_data, count, v);
+          }
+        _size = count;
+      }
+  }
+
+  /**
+   * Value initialized constructor. Initializes the vector with 'count'
+   * number of value initialized elements.
+   * @param count Number of elements to initialize.
+   */
+  explicit vl_vector (const size_t &count) : vl_vector (count, T ())
+  {}
+
+  /**
+   * Destructor.
+   */
+  ~vl_vector ()
+  {
+    vl_deallocate (_heap_data, _cap, Alignment);
+  }
+
+  /************* Iterator, Reverse Iterator and their Const **************/
+  using value_type = T;
+  using iterator = T *;
+  using const_iterator = const T *;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  /**
+   * @return an iterator to the beginning of the data.
+   */
+  iterator begin () noexcept (true)
+  {
+    return _heap_data;
+  }
+
+  /**
+   * @return an iterator to the end of the data.
+   */
+  iterator end () noexcept (true)
+  {
+    return _heap_data + _size;
+  }
+
+  /**
+   * @return a const iterator to the beginning of the data.
+   */
+  const_iterator begin () const noexcept (true)
+  {
+    return _heap_data;
+  }
+
+  /**
+   * @return a const iterator to the end of the data.
+   */
+  const_iterator end () const noexcept (true)
+  {
+    return _heap_data + _size;
+  }
+
+  /**
+   * @return a const iterator to the beginning of the data.
+   */
+  const_iterator cbegin () const noexcept (true)
+  {
+    return _heap_data;
+  }
+
+  /**
+   * @return a const iterator to the end of the data.
+   */
+  const_iterator cend () const noexcept (true)
+  {
+    return _heap_data + _size;
+  }
+
+  /**
+   * @return a reversed iterator to the beginning of the data.
+   */
+  reverse_iterator rbegin () noexcept (true)
+  {
+    return reverse_iterator (end ());
+  }
+
+  /**
+   * @return a reversed iterator to the end of the data.
+   */
+  reverse_iterator rend () noexcept (true)
+  {
+    return reverse_iterator (begin ());
+  }
+
+  /**
+   * @return a const reversed iterator to the beginning of the data.
+   */
+  const_reverse_iterator rbegin () const noexcept (true)
+  {
+    return const_reverse_iterator (end ());
+  }
+
+  /**
+   * @return a const reversed iterator to the end of the data.
+   */
+  const_reverse_iterator rend () const noexcept (true)
+  {
+    return const_reverse_iterator (begin ());
+  }
+
+  /**
+   * @return a const reversed iterator to the beginning of the data.
+   */
+  const_reverse_iterator crbegin () const noexcept (true)
+  {
+    return const_reverse_iterator (end ());
+  }
+
+  /**
+   * @return a const reversed iterator to the end of the data.
+   */
+  const_reverse_iterator crend () const noexcept (true)
+  {
+    return const_reverse_iterator (begin ());
+  }
+
+ protected:
+  /************* Protected Methods **************/
+
+  /**
+   * The capacity function that indicates the maximum amount of element
+   * a vector can contain, at any given moment.
+   * @param size Number of elements a vector contains.
+   * @param k Number of elements we want to add to a vector.
+   * @return The maximal amount of elements a vector can contain.
+   */
+  static size_t cap_c (const size_t &size, const size_t &k) noexcept (false)
+  {
+    return vl_grow_capacity (size, k, max_size ());
+  }
+
+  /**
+   * Tries to grow the heap memory to new_cap elements by remapping its
+   * pages instead of copying them (see vl_try_reallocate).
+   * @param new_cap The new capacity, larger than the current one.
+   * @return true if the heap memory was grown, otherwise false.
+   */
+  bool grow_heap (const size_t new_cap) noexcept (true)
+  {
+    if (_heap_data == nullptr)
+      {
+        return false;
+      }
+    T *grown = vl_try_reallocate (_heap_data, _cap, new_cap, Alignment);
+    if (grown == nullptr)
+      {
+        return false;
+      }
+    _heap_data = grown;
+    _cap = new_cap;
+    return true;
+  }
+
+ public:
+  /************* Public Methods **************/
+
+  /**
+   * @return a pointer to the data on the heap.
+   */
+  T *data () noexcept (true)
+  {
+    return _heap_data;
+  }
+
+  /**
+   * @return a const pointer to the data on the heap.
+   */
+  const T *data () const noexcept (true)
+  {
+    return _heap_data;
+  }
+
+  /**
+   * @param element A reference to const T.
+   * @return true if the vector contains the element, otherwise false.
+   */
+  bool contains (const T &element) const noexcept (false)
+  {
+    return std::find (begin (), end (), element) != end ();
+  }
+
+  /**
+   * Searches the elements, which must be in ascending order, without
+   * branches (see vl_branchless_lower_bound).
+   * @param value A value to search for.
+   * @return an iterator to the first element that isn't less than value,
+   *         or end () if there is none.
+   */
+  const_iterator lower_bound (const T &value) const noexcept (false)
+  {
+    return vl_branchless_lower_bound (_heap_data, _size, value);
+  }
+
+  /**
+   * @return the current amount of elements in the vector.
+   */
+  size_t size () const noexcept (true)
+  {
+    return _size;
+  }
+
+  /**
+   * @return the capacity of the vector.
+   */
+  size_t capacity () const noexcept (true)
+  {
+    return _cap;
+  }
+
+  /**
+   * @return the maximal amount of elements the vector can hold.
+   */
+  static constexpr size_t max_size () noexcept (true)
+  {
+    return vl_max_size<T> ();
+  }
+
+  /**
+   * @return true if the vector is empty, otherwise false.
+   */
+  bool empty () const noexcept (true)
+  {
+    return _size == 0;
+  }
+
+  /**
+   * Makes sure the vector can hold at least n elements without another
+   * allocation. Does nothing if the capacity is already large enough.
+   * @param n The requested capacity.
+   */
+  void reserve (const size_t n) noexcept (false)
+  {
+    if (n <= _cap || grow_heap (n))
+      {
+        return;
+      }
+    if (n > max_size ())
+      {
+        throw std::length_error{"Capacity exceeds max_size"};
+      }
+    T *temp = vl_allocate<T> (n, Alignment);
+    std::move (begin (), end (), temp);
+    vl_deallocate (_heap_data, _cap, Alignment);
+    _heap_data = temp;
+    _cap = n;
+  }
+
+  /**
+   * Gives the kernel a hint about how the heap memory will be accessed,
+   * for example MADV_SEQUENTIAL before a scan or MADV_WILLNEED before it's
+   * read. Only heap memory of at least HUGE_PAGE_THRESHOLD bytes, which is
+   * mapped on huge pages, takes hints.
+   * @param advice An madvise advice.
+   * @return true if the hint was given, otherwise false.
+   */
+  bool advise (const int advice) const noexcept (true)
+  {
+    return vl_advise (_heap_data, _cap * sizeof (T), advice);
+  }
+
+  /**
+   * @param i An index.
+   * @return A reference to the element at index i in the vector.
+   */
+  T &at (const size_t &i) noexcept (false)
+  {
+    if (i >= _size)
+      {
+        throw std::out_of_range{"Invalid index"};
+      }
+    return _heap_data[i];
+  }
+
+  /**
+   * @param i An index.
+   * @return The element at index i in the vector.
+   */
+  T at (const size_t &i) const noexcept (false)
+  {
+    if (i >= _size)
+      {
+        throw std::out_of_range{"Invalid index"};
+      }
+    return _heap_data[i];
+  }
+
+  /**
+   * Inserts all the element from first to end (not included) before
+   * the given position.
+   * @tparam ForwardIterator An iterator over the range we want to insert.
+   * @param position A pointer to a const T that the range of elements will
+   *                 be inserted before it.
+   * @param first An iterator to the first element in the given range.
+   * @param end An iterator to the last element (not included) in the
+   *            given range.
+   * @return An iterator to the first element in the inserted range.
+   */
+  template<class ForwardIterator>
+  iterator insert (const_iterator position, ForwardIterator first,
+                   ForwardIterator last) noexcept (false)
+  {
+    iterator pos = (iterator) position;
+    size_t k = last - first; // number of new elements to add
+    size_t index = pos - begin (); // where pos is, if the data is remapped
+    // where the range is, if it's a part of this vector.
+    const size_t from = vl_alias_index (_heap_data, _size, first);
+    if (_size + k > _cap
+        && (from != _size || !grow_heap (cap_c (_size, k))))
+      {
+        size_t new_cap = cap_c (_size, k);
+        T *temp = vl_allocate<T> (new_cap, Alignment);
+        iterator it_1 = std::copy (begin (), pos, temp);
+        iterator it_2 = std::copy (first, last, it_1);
+        std::copy (pos, end (), it_2);
+        vl_deallocate (_heap_data, _cap, Alignment);
+        _heap_data = temp;
+        _cap = new_cap;
+        pos = it_1;
+      }
+    else
+      {
+        // there is room, possibly after grow_heap remapped the data.
+        pos = begin () + index;
+        std::move_backward (pos, end (), end () + k);
+        if (from == _size)
+          {
+            std::copy (first, last, pos);
+          }
+        else
+          {
+            vl_copy_shifted (_heap_data, index, from, k);
+          }
+      }
+    _size += k;
+    return pos;
+  }
+
+  /**
+   * Inserts the given element before position.
+   * @param position A pointer to a const T that the element will be inserted
+   *                 before it.
+   * @param element An element to insert.
+   * @return An iterator to the new element that has been added.
+   */
+  iterator insert (const_iterator position, const T &element) noexcept (false)
+  {
+    return insert (position, &element, &element + 1);
+  }
+
+  /**
+   * Adds a new element to the end of the vector.
+   * @param element An element to add.
+   */
+  void push_back (const T &element) noexcept (false)
+  {
+    insert (end (), element);
+  }
+
+  /**
+   * Deletes all elements from first to last in this vector. The heap
+   * memory is kept.
+   * @param first An iterator to the first element to delete.
+   * @param last An iterator to the last element to delete.
+   * @return An iterator to the element to the right of the deleted range.
+   */
+  iterator erase (const_iterator first, const_iterator last) noexcept (false)
+  {
+    std::move ((iterator) last, end (), (iterator) first);
+    _size -= last - first;
+    return (iterator) first;
+  }
+
+  /**
+   * Deletes the element that 'it' points at from the vector.
+   * @param it A pointer to const T that will be deleted.
+   * @return An iterator to the element to the right of the deleted element.
+   */
+  iterator erase (const_iterator it) noexcept (false)
+  {
+    return erase (it, it + 1);
+  }
+
+  /**
+   * Deletes the last element from the vector.
+   */
+  void pop_back () noexcept (false)
+  {
+    if (_size == 0)
+      {
+        return;
+      }
+    --_size;
+  }
+
+  /**
+   * Changes the number of elements to count, by deleting the last elements
+   * or by adding copies of v at the end. Grows like insert, unless the
+   * capacity was reserved in advance.
+   * @param count The new number of elements.
+   * @param v The value of the added elements.
+   */
+  void resize (const size_t count, const T &v = T ()) noexcept (false)
+  {
+    if (count <= _size)
+      {
+        erase (begin () + count, end ());
+        return;
+      }
+    if (count > _cap)
+      {
+        reserve (cap_c (_size, count - _size));
+      }
+    vl_bulk_fill (_heap_data + _size, count - _size, v);
+    _size = count;
+  }
+
+  /**
+   * Deletes all elements from the vector, and frees the heap memory.
+   */
+  void clear () noexcept (false)
+  {
+    vl_deallocate (_heap_data, _cap, Alignment);
+    _heap_data = nullptr;
+    _size = 0;
+    _cap = 0;
+  }
+
+  /**
+   * Sorts the elements in ascending order. Integral and floating point
+   * elements are radix sorted (see vl_sort_elements), with the spare
+   * capacity as scratch memory when it's large enough, or sorted by
+   * sorting networks when there are at most SORT_NETWORK_MAX of them.
+   */
+  void sort () noexcept (false)
+  {
+    vl_sort_elements (_heap_data, _size, _heap_data + _size, _cap - _size,
+                      false);
+  }
+
+  /**
+   * Sorts the elements in ascending order, and keeps equal elements in
+   * their order.
+   */
+  void stable_sort () noexcept (false)
+  {
+    vl_sort_elements (_heap_data, _size, _heap_data + _size, _cap - _size,
+                      true);
+  }
+
+  /************* Operators Overloading **************/
+
+  /**
+   * @param i An index which belongs to [0,size of vector).
+   * @return A reference to the element at the index.
+   */
+  T &operator[] (const size_t &i) noexcept (true)
+  {
+    return _heap_data[i];
+  }
+
+  /**
+   * @param i An index which belongs to [0,size of vector).
+   * @return The element at the index.
+   */
+  T operator[] (const size_t &i) const noexcept (true)
+  {
+    return _heap_data[i];
+  }
+
+  /**
+   * Assignment operator - assigns another vl_vector to this.
+   * @param rhs Another vl_vector object to assign.
+   * @return this.
+   */
+  vl_vector &operator= (const vl_vector &rhs) noexcept (false)
+  {
+    if (this != &rhs)
+      {
+        clear ();
+        if (rhs._cap != 0)
+          {
+            _heap_data = vl_allocate<T> (rhs._cap, Alignment);
+            vl_bulk_copy (rhs.begin (), rhs.end (), _heap_data);
+          }
+        _size = rhs._size;
+        _cap = rhs._cap;
+      }
+    return *this;
+  }
+
+  /**
+   * Move assignment operator - steals the data of another vl_vector and
+   * leaves it empty.
+   * @param rhs Another vl_vector object to move from.
+   * @return this.
+   */
+  vl_vector &operator= (vl_vector &&rhs) noexcept (true)
+  {
+    if (this != &rhs)
+      {
+        vl_deallocate (_heap_data, _cap, Alignment);
+        _heap_data = rhs._heap_data;
+        _size = rhs._size;
+        _cap = rhs._cap;
+        rhs._heap_data = nullptr;
+        rhs._size = 0;
+        rhs._cap = 0;
+      }
+    return *this;
+  }
+
+  /**
+   * Checks if both object's size and elements are equal, and they appear
+   * at the same order.
+   * @param rhs Another vl_vector object to compare with.
+   * @return true if this and rhs are equal, otherwise false.
+   */
+  bool operator== (const vl_vector &rhs) const noexcept (false)
+  {
+    return (_size == rhs._size) && std::equal (begin (), end (), rhs.begin ());
+  }
+
+  /**
+   * Checks if both object's size and elements are equal, and they appear
+   * at the same order.
+   * @param rhs Another vl_vector object to compare with.
+   * @return true if this and rhs are not equal, otherwise false.
+   */
+  bool operator!= (const vl_vector &rhs) const noexcept (false)
+  {
+    return !(*this == rhs);
+  }
+
+#if __cplusplus >= 202002L
+  /**
+   * Enables implicit casting from this to std::span<T>.
+   * @return a span over the elements of this.
+   */
+  operator std::span<T> () noexcept (true)
+  {
+    return std::span<T> (_heap_data, _size);
+  }
+
+  /**
+   * Enables implicit casting from this to std::span<const T>.
+   * @return a span over the elements of this.
+   */
+  operator std::span<const T> () const noexcept (true)
+  {
+    return std::span<const T> (_heap_data, _size);
+  }
+#endif
+
 };
 #endif //_VL_VECTOR_H_